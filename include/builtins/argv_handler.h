@@ -38,7 +38,7 @@ class ArgvBuiltinHandler {
     }
 
     auto argv = std::make_shared<List>();
-    auto& elements = argv->elements;
+    auto& elements = argv->elements();
 
     for (const auto& pair : kiwiArgs) {
       if (String::beginsWith(pair.first, "argv_")) {
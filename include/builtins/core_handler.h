@@ -210,7 +210,7 @@ class CoreBuiltinHandler {
 
     auto newList = std::make_shared<List>();
     auto stringValue = get_string(term, value);
-    auto& elements = newList->elements;
+    auto& elements = newList->elements();
 
     for (char c : stringValue) {
       elements.emplace_back(k_string(1, c));
@@ -251,7 +251,8 @@ class CoreBuiltinHandler {
     auto memberHash = std::make_shared<Hash>();
     auto obj = std::get<k_object>(value);
     auto& instanceVariables = obj->instanceVariables;
-    auto clazz = classes[obj->className];
+    std::shared_lock<std::shared_mutex> lock(definitionsMutex);
+    const auto& clazz = classes.at(obj->className);
 
     for (const auto& method : clazz.getMethods()) {
       memberHash->add(method.first, {});
@@ -277,7 +278,7 @@ class CoreBuiltinHandler {
     }
 
     auto list = std::get<k_list>(value);
-    auto& elements = list->elements;
+    auto& elements = list->elements();
     std::ostringstream sv;
     k_string joiner;
 
@@ -301,12 +302,14 @@ class CoreBuiltinHandler {
       throw BuiltinUnexpectedArgumentError(term, KiwiBuiltins.Size);
     }
 
-    if (std::holds_alternative<k_string>(value)) {
-      return static_cast<k_int>(std::get<k_string>(value).length());
+    if (std::holds_alternative<k_text>(value)) {
+      return static_cast<k_int>(std::get<k_text>(value).str().length());
     } else if (std::holds_alternative<k_list>(value)) {
-      return static_cast<k_int>(std::get<k_list>(value)->elements.size());
+      return static_cast<k_int>(std::get<k_list>(value)->view().size());
     } else if (std::holds_alternative<k_hash>(value)) {
       return static_cast<k_int>(std::get<k_hash>(value)->size());
+    } else if (std::holds_alternative<k_bytes>(value)) {
+      return static_cast<k_int>(std::get<k_bytes>(value)->size());
     }
 
     throw InvalidOperationError(
@@ -319,12 +322,17 @@ class CoreBuiltinHandler {
       throw BuiltinUnexpectedArgumentError(term, KiwiBuiltins.ToHex);
     }
 
+    if (std::holds_alternative<k_bytes>(value)) {
+      return String::toHex(std::get<k_bytes>(value)->view());
+    }
+
     if (!std::holds_alternative<k_list>(value)) {
-      throw InvalidOperationError(
-          term, "Expected a `List` value for byte to string conversion.");
+      throw InvalidOperationError(term,
+                                  "Expected a `Bytes` or `List` value for byte "
+                                  "to string conversion.");
     }
 
-    auto& elements = std::get<k_list>(value)->elements;
+    auto& elements = std::get<k_list>(value)->elements();
 
     if (elements.empty()) {
       throw EmptyListError(term);
@@ -351,37 +359,31 @@ class CoreBuiltinHandler {
       throw BuiltinUnexpectedArgumentError(term, KiwiBuiltins.ToBytes);
     }
 
-    if (std::holds_alternative<k_string>(value)) {
-      auto stringValue = std::get<k_string>(value);
-      std::vector<uint8_t> bytes(stringValue.begin(), stringValue.end());
-      auto byteList = std::make_shared<List>();
-      auto& elements = byteList->elements;
-
-      for (const auto& byte : bytes) {
-        elements.emplace_back(static_cast<k_int>(byte));
-      }
-
-      return byteList;
+    if (std::holds_alternative<k_text>(value)) {
+      const auto& stringValue = std::get<k_text>(value).str();
+      return std::make_shared<Bytes>(
+          std::vector<uint8_t>(stringValue.begin(), stringValue.end()));
+    } else if (std::holds_alternative<k_bytes>(value)) {
+      return std::get<k_bytes>(value)->clone();
     } else if (std::holds_alternative<k_list>(value)) {
-      auto listElements = std::get<k_list>(value)->elements;
-      auto byteList = std::make_shared<List>();
-      auto& elements = byteList->elements;
+      const auto& listElements = std::get<k_list>(value)->view();
+      std::vector<uint8_t> bytes;
+      bytes.reserve(listElements.size());
 
       for (const auto& item : listElements) {
-        if (!std::holds_alternative<k_string>(item)) {
+        if (std::holds_alternative<k_int>(item)) {
+          bytes.push_back(static_cast<uint8_t>(std::get<k_int>(item) & 0xFF));
+        } else if (std::holds_alternative<k_text>(item)) {
+          const auto& stringValue = std::get<k_text>(item).str();
+          bytes.insert(bytes.end(), stringValue.begin(), stringValue.end());
+        } else {
           throw InvalidOperationError(
-              term, "Expected a `List` to contain only `String` values.");
-        }
-
-        auto stringValue = std::get<k_string>(item);
-        std::vector<uint8_t> bytes(stringValue.begin(), stringValue.end());
-
-        for (const auto& byte : bytes) {
-          elements.emplace_back(static_cast<k_int>(byte));
+              term,
+              "Expected a `List` to contain only `String` or `Integer` values.");
         }
       }
 
-      return byteList;
+      return std::make_shared<Bytes>(std::move(bytes));
     } else {
       throw InvalidOperationError(
           term, "Expected a `String` or `List` to convert to bytes.");
@@ -394,8 +396,8 @@ class CoreBuiltinHandler {
       throw BuiltinUnexpectedArgumentError(term, KiwiBuiltins.ToD);
     }
 
-    if (std::holds_alternative<k_string>(value)) {
-      k_string stringValue = std::get<k_string>(value);
+    if (std::holds_alternative<k_text>(value)) {
+      k_string stringValue = std::get<k_text>(value).str();
       double doubleValue = 0;
       auto [ptr, ec] =
           std::from_chars(stringValue.data(),
@@ -422,8 +424,8 @@ class CoreBuiltinHandler {
       throw BuiltinUnexpectedArgumentError(term, KiwiBuiltins.ToI);
     }
 
-    if (std::holds_alternative<k_string>(value)) {
-      k_string stringValue = std::get<k_string>(value);
+    if (std::holds_alternative<k_text>(value)) {
+      k_string stringValue = std::get<k_text>(value).str();
       k_int intValue = 0;
       auto [ptr, ec] =
           std::from_chars(stringValue.data(),
@@ -450,6 +452,11 @@ class CoreBuiltinHandler {
       throw BuiltinUnexpectedArgumentError(term, KiwiBuiltins.ToS);
     }
 
+    // Bytes convert to the text they hold.
+    if (std::holds_alternative<k_bytes>(value)) {
+      return k_string(std::get<k_bytes>(value)->view());
+    }
+
     return Serializer::serialize(value);
   }
 
@@ -459,7 +466,7 @@ class CoreBuiltinHandler {
       throw BuiltinUnexpectedArgumentError(term, KiwiBuiltins.Substring);
     }
 
-    if (!std::holds_alternative<k_string>(value)) {
+    if (!std::holds_alternative<k_text>(value)) {
       throw InvalidOperationError(term,
                                   "Expected a `String` value for builtin `" +
                                       KiwiBuiltins.Substring + "`.");
@@ -482,10 +489,10 @@ class CoreBuiltinHandler {
       throw BuiltinUnexpectedArgumentError(term, KiwiBuiltins.Find);
     }
 
-    auto stringValue = get_string(term, value);
+    auto text = get_text(term, value);
     auto pattern = get_string(term, args.at(0));
 
-    return String::find(stringValue, pattern);
+    return String::find(text, pattern);
   }
 
   static k_value executeMatch(const Token& term, const k_value& value,
@@ -494,10 +501,10 @@ class CoreBuiltinHandler {
       throw BuiltinUnexpectedArgumentError(term, KiwiBuiltins.Match);
     }
 
-    auto stringValue = get_string(term, value);
+    auto text = get_text(term, value);
     auto pattern = get_string(term, args.at(0));
 
-    return String::match(stringValue, pattern);
+    return String::match(text, pattern);
   }
 
   static k_value executeMatches(const Token& term, const k_value& value,
@@ -506,10 +513,10 @@ class CoreBuiltinHandler {
       throw BuiltinUnexpectedArgumentError(term, KiwiBuiltins.Matches);
     }
 
-    auto stringValue = get_string(term, value);
+    auto text = get_text(term, value);
     auto pattern = get_string(term, args.at(0));
 
-    return String::matches(stringValue, pattern);
+    return String::matches(text, pattern);
   }
 
   static k_value executeMatchesAll(const Token& term, const k_value& value,
@@ -518,10 +525,10 @@ class CoreBuiltinHandler {
       throw BuiltinUnexpectedArgumentError(term, KiwiBuiltins.MatchesAll);
     }
 
-    auto stringValue = get_string(term, value);
+    auto text = get_text(term, value);
     auto pattern = get_string(term, args.at(0));
 
-    return String::matchesAll(stringValue, pattern);
+    return String::matchesAll(text, pattern);
   }
 
   static k_value executeScan(const Token& term, const k_value& value,
@@ -530,10 +537,10 @@ class CoreBuiltinHandler {
       throw BuiltinUnexpectedArgumentError(term, KiwiBuiltins.Scan);
     }
 
-    auto stringValue = get_string(term, value);
+    auto text = get_text(term, value);
     auto pattern = get_string(term, args.at(0));
 
-    return String::scan(stringValue, pattern);
+    return String::scan(text, pattern);
   }
 
   static k_value executeSplit(const Token& term, const k_value& value,
@@ -542,10 +549,10 @@ class CoreBuiltinHandler {
       throw BuiltinUnexpectedArgumentError(term, KiwiBuiltins.Split);
     }
 
-    k_string input = get_string(term, value);
+    auto input = get_text(term, value);
     auto delimiter = get_string(term, args.at(0));
     auto newList = std::make_shared<List>();
-    auto& elements = newList->elements;
+    auto& elements = newList->elements();
     k_int limit = -1;
 
     if (args.size() == 2) {
@@ -668,18 +675,18 @@ class CoreBuiltinHandler {
       throw BuiltinUnexpectedArgumentError(term, KiwiBuiltins.BeginsWith);
     }
 
-    return String::beginsWith(get_string(term, value),
+    return String::beginsWith(get_text(term, value),
                               get_string(term, args.at(0)));
   }
 
   static k_value executeStringContains(const Token& term, const k_value& value,
                                        const k_value& arg) {
-    return String::contains(get_string(term, value), get_string(term, arg));
+    return String::contains(get_text(term, value), get_string(term, arg));
   }
 
   static k_value executeListContains(const k_value& value, const k_value& arg) {
     auto list = std::get<k_list>(value);
-    auto& elements = list->elements;
+    auto& elements = list->elements();
 
     for (const auto& item : elements) {
       if (same_value(item, arg)) {
@@ -696,7 +703,8 @@ class CoreBuiltinHandler {
       throw BuiltinUnexpectedArgumentError(term, KiwiBuiltins.Contains);
     }
 
-    if (std::holds_alternative<k_string>(value)) {
+    if (std::holds_alternative<k_text>(value) ||
+        std::holds_alternative<k_bytes>(value)) {
       return executeStringContains(term, value, args.at(0));
     } else if (std::holds_alternative<k_list>(value)) {
       return executeListContains(value, args.at(0));
@@ -711,7 +719,7 @@ class CoreBuiltinHandler {
       throw BuiltinUnexpectedArgumentError(term, KiwiBuiltins.Contains);
     }
 
-    return String::endsWith(get_string(term, value),
+    return String::endsWith(get_text(term, value),
                             get_string(term, args.at(0)));
   }
 
@@ -727,6 +735,7 @@ class CoreBuiltinHandler {
         const auto& obj = std::get<k_object>(value);
         const auto& className = obj->className;
 
+        std::shared_lock<std::shared_mutex> lock(definitionsMutex);
         return same_value(className, typeName) ||
                same_value(classes.at(className).getBaseClassName(), typeName);
       }
@@ -758,6 +767,9 @@ class CoreBuiltinHandler {
       case 7:  // k_lambda
         return typeName == TypeNames.With;
 
+      case 9:  // k_bytes
+        return typeName == TypeNames.Bytes;
+
       default:
         return false;
     }
@@ -780,15 +792,15 @@ class CoreBuiltinHandler {
       throw BuiltinUnexpectedArgumentError(term, KiwiBuiltins.Reverse);
     }
 
-    if (std::holds_alternative<k_string>(value)) {
-      auto s = std::get<k_string>(value);
+    if (std::holds_alternative<k_text>(value)) {
+      auto s = std::get<k_text>(value).str();
       std::reverse(s.begin(), s.end());
       return s;
     } else if (std::holds_alternative<k_list>(value)) {
-      auto v = std::get<k_list>(value)->elements;
+      auto v = std::get<k_list>(value)->view();
       std::reverse(v.begin(), v.end());
       auto list = std::make_shared<List>();
-      list->elements = v;
+      list->elements() = v;
       return list;
     }
 
@@ -803,8 +815,8 @@ class CoreBuiltinHandler {
       throw BuiltinUnexpectedArgumentError(term, KiwiBuiltins.IndexOf);
     }
 
-    if (std::holds_alternative<k_string>(value)) {
-      return static_cast<k_int>(String::indexOf(std::get<k_string>(value),
+    if (std::holds_alternative<k_text>(value)) {
+      return static_cast<k_int>(String::indexOf(std::get<k_text>(value).str(),
                                                 get_string(term, args.at(0))));
     } else if (std::holds_alternative<k_list>(value)) {
       return indexof_listvalue(std::get<k_list>(value), args.at(0));
@@ -821,9 +833,9 @@ class CoreBuiltinHandler {
       throw BuiltinUnexpectedArgumentError(term, KiwiBuiltins.LastIndexOf);
     }
 
-    if (std::holds_alternative<k_string>(value)) {
+    if (std::holds_alternative<k_text>(value)) {
       return static_cast<k_int>(String::lastIndexOf(
-          std::get<k_string>(value), get_string(term, args.at(0))));
+          std::get<k_text>(value).str(), get_string(term, args.at(0))));
     } else if (std::holds_alternative<k_list>(value)) {
       return lastindexof_listvalue(std::get<k_list>(value), args.at(0));
     }
@@ -857,12 +869,14 @@ class CoreBuiltinHandler {
       throw BuiltinUnexpectedArgumentError(term, KiwiBuiltins.Empty);
     }
 
-    if (std::holds_alternative<k_string>(value)) {
-      return std::get<k_string>(value).empty();
+    if (std::holds_alternative<k_text>(value)) {
+      return std::get<k_text>(value).str().empty();
     } else if (std::holds_alternative<k_list>(value)) {
-      return std::get<k_list>(value)->elements.empty();
+      return std::get<k_list>(value)->view().empty();
     } else if (std::holds_alternative<k_hash>(value)) {
-      return std::get<k_hash>(value)->keys.empty();
+      return std::get<k_hash>(value)->keys().empty();
+    } else if (std::holds_alternative<k_bytes>(value)) {
+      return std::get<k_bytes>(value)->size() == 0;
     } else if (std::holds_alternative<k_int>(value)) {
       return std::get<k_int>(value) == 0;
     } else if (std::holds_alternative<double>(value)) {
@@ -881,12 +895,18 @@ class CoreBuiltinHandler {
       throw BuiltinUnexpectedArgumentError(term, KiwiBuiltins.Push);
     }
 
+    if (std::holds_alternative<k_bytes>(value)) {
+      auto byte = get_integer(term, args.at(0));
+      std::get<k_bytes>(value)->push(static_cast<uint8_t>(byte & 0xFF));
+      return true;
+    }
+
     if (!std::holds_alternative<k_list>(value)) {
       throw InvalidOperationError(
           term, "Expected a `List` for builtin `" + KiwiBuiltins.Push + "`.");
     }
 
-    std::get<k_list>(value)->elements.push_back(args.at(0));
+    std::get<k_list>(value)->elements().push_back(args.at(0));
     return true;
   }
 
@@ -901,7 +921,7 @@ class CoreBuiltinHandler {
           term, "Expected a `List` for builtin `" + KiwiBuiltins.Pop + "`.");
     }
 
-    auto& elements = std::get<k_list>(value)->elements;
+    auto& elements = std::get<k_list>(value)->elements();
 
     if (elements.empty()) {
       return static_cast<k_int>(0);
@@ -923,7 +943,7 @@ class CoreBuiltinHandler {
                                             KiwiBuiltins.Enqueue + "`.");
     }
 
-    std::get<k_list>(value)->elements.push_back(args.at(0));
+    std::get<k_list>(value)->elements().push_back(args.at(0));
     return true;
   }
 
@@ -938,7 +958,7 @@ class CoreBuiltinHandler {
                                             KiwiBuiltins.Dequeue + "`.");
     }
 
-    auto& elements = std::get<k_list>(value)->elements;
+    auto& elements = std::get<k_list>(value)->elements();
 
     if (elements.empty()) {
       return static_cast<k_int>(0);
@@ -960,7 +980,7 @@ class CoreBuiltinHandler {
           term, "Expected a `List` for builtin `" + KiwiBuiltins.Shift + "`.");
     }
 
-    auto& elements = std::get<k_list>(value)->elements;
+    auto& elements = std::get<k_list>(value)->elements();
 
     if (elements.empty()) {
       return static_cast<k_int>(0);
@@ -982,7 +1002,7 @@ class CoreBuiltinHandler {
                                             KiwiBuiltins.Unshift + "`.");
     }
 
-    auto& elements = std::get<k_list>(value)->elements;
+    auto& elements = std::get<k_list>(value)->elements();
     elements.insert(elements.begin(), args.at(0));
     return value;
   }
@@ -998,8 +1018,8 @@ class CoreBuiltinHandler {
           term, "Expected a `List` for builtin `" + KiwiBuiltins.Concat + "`.");
     }
 
-    auto& elements = std::get<k_list>(value)->elements;
-    const auto& concat = std::get<k_list>(args.at(0))->elements;
+    auto& elements = std::get<k_list>(value)->elements();
+    const auto& concat = std::get<k_list>(args.at(0))->elements();
     elements.insert(elements.end(), concat.begin(), concat.end());
     return value;
   }
@@ -1015,7 +1035,7 @@ class CoreBuiltinHandler {
           term, "Expected a `List` for builtin `" + KiwiBuiltins.Insert + "`.");
     }
 
-    auto& elements = std::get<k_list>(value)->elements;
+    auto& elements = std::get<k_list>(value)->elements();
     size_t index = get_integer(term, args.at(1));
 
     if (index > elements.size()) {
@@ -1038,7 +1058,7 @@ class CoreBuiltinHandler {
           term, "Expected a `List` for builtin `" + KiwiBuiltins.Remove + "`.");
     }
 
-    auto& elements = std::get<k_list>(value)->elements;
+    auto& elements = std::get<k_list>(value)->elements();
     auto it = std::find(elements.begin(), elements.end(), args.at(0));
 
     if (it != elements.end()) {
@@ -1059,7 +1079,7 @@ class CoreBuiltinHandler {
                                             KiwiBuiltins.RemoveAt + "`.");
     }
 
-    auto& elements = std::get<k_list>(value)->elements;
+    auto& elements = std::get<k_list>(value)->elements();
     size_t index = get_integer(term, args.at(0));
 
     if (index >= elements.size()) {
@@ -1082,7 +1102,7 @@ class CoreBuiltinHandler {
           term, "Expected a `List` for builtin `" + KiwiBuiltins.Rotate + "`.");
     }
 
-    auto& elements = std::get<k_list>(value)->elements;
+    auto& elements = std::get<k_list>(value)->elements();
     auto rotation = get_integer(term, args[0]);
 
     if (elements.empty()) {
@@ -1116,7 +1136,7 @@ class CoreBuiltinHandler {
           term, "Expected a `List` for builtin `" + KiwiBuiltins.Unique + "`.");
     }
 
-    auto& elements = std::get<k_list>(value)->elements;
+    auto& elements = std::get<k_list>(value)->elements();
     std::unordered_set<k_value> seen;
     auto newEnd = std::remove_if(
         elements.begin(), elements.end(),
@@ -1136,7 +1156,7 @@ class CoreBuiltinHandler {
           term, "Expected a `List` for builtin `" + KiwiBuiltins.Count + "`.");
     }
 
-    const auto& elements = std::get<k_list>(value)->elements;
+    const auto& elements = std::get<k_list>(value)->elements();
     return std::count(elements.begin(), elements.end(), args.at(0));
   }
 
@@ -1155,15 +1175,15 @@ class CoreBuiltinHandler {
     std::function<void(const k_value&)> flattenElement;
     flattenElement = [&flattened, &flattenElement](const k_value& element) {
       if (std::holds_alternative<k_list>(element)) {
-        for (const auto& subElement : std::get<k_list>(element)->elements) {
+        for (const auto& subElement : std::get<k_list>(element)->elements()) {
           flattenElement(subElement);
         }
       } else {
-        flattened->elements.push_back(element);
+        flattened->elements().push_back(element);
       }
     };
 
-    const auto& elements = std::get<k_list>(value)->elements;
+    const auto& elements = std::get<k_list>(value)->elements();
     for (const auto& element : elements) {
       flattenElement(element);
     }
@@ -1181,16 +1201,16 @@ class CoreBuiltinHandler {
           term, "Expected a `List` for builtin `" + KiwiBuiltins.Zip + "`.");
     }
 
-    const auto& elements1 = std::get<k_list>(value)->elements;
-    const auto& elements2 = std::get<k_list>(args.at(0))->elements;
+    const auto& elements1 = std::get<k_list>(value)->elements();
+    const auto& elements2 = std::get<k_list>(args.at(0))->elements();
     auto zipped = std::make_shared<List>();
     auto win_min = (elements1.size() < elements2.size()) ? elements1.size()
                                                          : elements2.size();
     for (size_t i = 0; i < win_min; ++i) {
       auto pair = std::make_shared<List>();
-      pair->elements.push_back(elements1.at(i));
-      pair->elements.push_back(elements2.at(i));
-      zipped->elements.push_back(pair);
+      pair->elements().push_back(elements1.at(i));
+      pair->elements().push_back(elements2.at(i));
+      zipped->elements().push_back(pair);
     }
 
     return zipped;
@@ -1207,7 +1227,7 @@ class CoreBuiltinHandler {
           term, "Expected a `List` for builtin `" + KiwiBuiltins.Slice + "`.");
     }
 
-    auto& elements = std::get<k_list>(value)->elements;
+    auto& elements = std::get<k_list>(value)->elements();
     auto start = static_cast<size_t>(get_integer(term, args.at(0)));
     auto end = static_cast<size_t>(get_integer(term, args.at(1)));
 
@@ -1217,7 +1237,7 @@ class CoreBuiltinHandler {
     }
 
     auto slicedList = std::make_shared<List>();
-    auto& slice = slicedList->elements;
+    auto& slice = slicedList->elements();
     slice.insert(slice.begin(), elements.begin() + start,
                  elements.begin() + end);
     return slicedList;
@@ -1230,18 +1250,29 @@ class CoreBuiltinHandler {
     }
 
     if (std::holds_alternative<k_list>(value)) {
-      std::get<k_list>(value)->elements.clear();
+      std::get<k_list>(value)->elements().clear();
       return value;
     } else if (std::holds_alternative<k_hash>(value)) {
       auto hash = std::get<k_hash>(value);
-      hash->keys.clear();
-      hash->kvp.clear();
+      hash->clear();
       return hash;
     }
 
     throw InvalidOperationError(
         term, "Invalid type for builtin `" + KiwiBuiltins.Empty + "`.");
   }
+
+  // Strings and bytes, such as a mapped file, are searched where they lie.
+  static std::string_view get_text(const Token& term, const k_value& value) {
+    if (std::holds_alternative<k_bytes>(value)) {
+      return std::get<k_bytes>(value)->view();
+    }
+
+    if (!std::holds_alternative<k_text>(value)) {
+      throw ConversionError(term, "Expected a String value.");
+    }
+    return std::get<k_text>(value).str();
+  }
 };
 
 #endif
\ No newline at end of file
@@ -50,6 +50,10 @@ class EncoderBuiltinHandler {
       throw BuiltinUnexpectedArgumentError(term, EncoderBuiltins.Base64Encode);
     }
 
+    if (std::holds_alternative<k_bytes>(args.at(0))) {
+      return String::base64Encode(std::get<k_bytes>(args.at(0))->view());
+    }
+
     auto value = get_string(term, args.at(0));
     return String::base64Encode(value);
   }
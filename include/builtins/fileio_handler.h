@@ -6,6 +6,9 @@
 #include "parsing/builtins.h"
 #include "parsing/tokens.h"
 #include "util/file.h"
+#include "util/file_reader.h"
+#include "util/file_writer.h"
+#include "util/mapped_file.h"
 #include "typing/value.h"
 
 class FileIOBuiltinHandler {
@@ -77,6 +80,9 @@ class FileIOBuiltinHandler {
       case KName::Builtin_FileIO_ReadBytes:
         return executeReadBytes(token, args);
 
+      case KName::Builtin_FileIO_MapFile:
+        return executeMapFile(token, args);
+
       case KName::Builtin_FileIO_FileSize:
         return executeGetFileSize(token, args);
 
@@ -98,6 +104,27 @@ class FileIOBuiltinHandler {
       case KName::Builtin_FileIO_WriteBytes:
         return executeWriteBytes(token, args);
 
+      case KName::Builtin_FileIO_OpenReader:
+        return executeOpenReader(token, args);
+
+      case KName::Builtin_FileIO_OpenWriter:
+        return executeOpenWriter(token, args);
+
+      case KName::Builtin_FileIO_Flush:
+        return executeFlush(token, args);
+
+      case KName::Builtin_FileIO_ReadLine:
+        return executeReadLine(token, args);
+
+      case KName::Builtin_FileIO_ReadChunk:
+        return executeReadChunk(token, args);
+
+      case KName::Builtin_FileIO_EndOfFile:
+        return executeEndOfFile(token, args);
+
+      case KName::Builtin_FileIO_Close:
+        return executeClose(token, args);
+
       default:
         break;
     }
@@ -112,6 +139,10 @@ class FileIOBuiltinHandler {
       throw BuiltinUnexpectedArgumentError(token, FileIOBuiltIns.AppendText);
     }
 
+    if (auto writer = get_writer(args.at(0))) {
+      return writeText(token, writer, args.at(1), false);
+    }
+
     auto fileName = get_string(token, args.at(0));
     auto value = args.at(1);
     return File::writeToFile(fileName, value, true, false);
@@ -157,7 +188,7 @@ class FileIOBuiltinHandler {
 
     auto path = get_string(token, args.at(0));
     auto list = std::make_shared<List>();
-    auto& elements = list->elements;
+    auto& elements = list->elements();
 
     for (const auto& entry : File::listDirectory(path)) {
       elements.emplace_back(entry);
@@ -320,7 +351,7 @@ class FileIOBuiltinHandler {
     auto glob = get_string(token, args.at(0));
     auto matchedFiles = File::expandGlob(glob);
     auto matchList = std::make_shared<List>();
-    auto& elements = matchList->elements;
+    auto& elements = matchList->elements();
 
     for (const auto& file : matchedFiles) {
       elements.emplace_back(file);
@@ -371,7 +402,7 @@ class FileIOBuiltinHandler {
     auto lines = File::readLines(fileName);
 
     auto list = std::make_shared<List>();
-    auto& elements = list->elements;
+    auto& elements = list->elements();
     elements.reserve(lines.size());
 
     for (const auto& line : lines) {
@@ -381,6 +412,125 @@ class FileIOBuiltinHandler {
     return list;
   }
 
+  static k_value executeOpenReader(const Token& token,
+                                   const std::vector<k_value>& args) {
+    if (args.size() != 1) {
+      throw BuiltinUnexpectedArgumentError(token, FileIOBuiltIns.OpenReader);
+    }
+
+    auto fileName = get_string(token, args.at(0));
+    auto reader = FileReader::open(fileName);
+    if (!reader) {
+      throw FileReadError(token, fileName);
+    }
+
+    return std::static_pointer_cast<Handle>(reader);
+  }
+
+  static k_value executeOpenWriter(const Token& token,
+                                   const std::vector<k_value>& args) {
+    if (args.size() != 2) {
+      throw BuiltinUnexpectedArgumentError(token, FileIOBuiltIns.OpenWriter);
+    }
+
+    auto fileName = get_string(token, args.at(0));
+    auto mode = get_string(token, args.at(1));
+    if (mode != "w" && mode != "a") {
+      throw InvalidOperationError(
+          token, "Expected a file mode of \"w\" (write) or \"a\" (append).");
+    }
+
+    auto writer = FileWriter::open(fileName, mode == "a");
+    if (!writer) {
+      throw FileWriteError(token, fileName);
+    }
+
+    return std::static_pointer_cast<Handle>(writer);
+  }
+
+  static k_value executeFlush(const Token& token,
+                              const std::vector<k_value>& args) {
+    if (args.size() != 1) {
+      throw BuiltinUnexpectedArgumentError(token, FileIOBuiltIns.Flush);
+    }
+
+    auto writer = get_writer(args.at(0));
+    if (!writer) {
+      throw ConversionError(token, "Expected a FileWriter value.");
+    }
+
+    return writer->flush();
+  }
+
+  static k_value executeReadLine(const Token& token,
+                                 const std::vector<k_value>& args) {
+    if (args.size() != 1) {
+      throw BuiltinUnexpectedArgumentError(token, FileIOBuiltIns.ReadLine);
+    }
+
+    k_string line;
+    get_reader(token, args.at(0))->readLine(line);
+    return line;
+  }
+
+  static k_value executeReadChunk(const Token& token,
+                                  const std::vector<k_value>& args) {
+    if (args.size() != 2) {
+      throw BuiltinUnexpectedArgumentError(token, FileIOBuiltIns.ReadChunk);
+    }
+
+    auto reader = get_reader(token, args.at(0));
+    auto size = get_integer(token, args.at(1));
+    if (size < 0) {
+      throw InvalidOperationError(token, "Expected a non-negative size.");
+    }
+
+    return reader->read(static_cast<size_t>(size));
+  }
+
+  static k_value executeEndOfFile(const Token& token,
+                                  const std::vector<k_value>& args) {
+    if (args.size() != 1) {
+      throw BuiltinUnexpectedArgumentError(token, FileIOBuiltIns.EndOfFile);
+    }
+
+    return get_reader(token, args.at(0))->eof();
+  }
+
+  static k_value executeClose(const Token& token,
+                              const std::vector<k_value>& args) {
+    if (args.size() != 1) {
+      throw BuiltinUnexpectedArgumentError(token, FileIOBuiltIns.Close);
+    }
+
+    if (auto writer = get_writer(args.at(0))) {
+      writer->close();
+    } else {
+      get_reader(token, args.at(0))->close();
+    }
+    return true;
+  }
+
+  static std::shared_ptr<FileReader> get_reader(const Token& token,
+                                                const k_value& arg) {
+    std::shared_ptr<FileReader> reader;
+    if (std::holds_alternative<k_handle>(arg)) {
+      reader = std::dynamic_pointer_cast<FileReader>(std::get<k_handle>(arg));
+    }
+
+    if (!reader) {
+      throw ConversionError(token, "Expected a FileReader value.");
+    }
+    return reader;
+  }
+
+  static std::shared_ptr<FileWriter> get_writer(const k_value& arg) {
+    if (!std::holds_alternative<k_handle>(arg)) {
+      return nullptr;
+    }
+    return std::dynamic_pointer_cast<FileWriter>(std::get<k_handle>(arg));
+  }
+
   static k_value executeReadBytes(const Token& token,
                                   const std::vector<k_value>& args) {
     if (args.size() != 3) {
@@ -391,17 +541,22 @@ class FileIOBuiltinHandler {
     auto offset = get_integer(token, args.at(1));
     auto size = get_integer(token, args.at(2));
 
-    auto bytes = File::readBytes(fileName, offset, size);
-    auto list = std::make_shared<List>();
-    auto& elements = list->elements;
+    return std::make_shared<Bytes>(File::readBytes(fileName, offset, size));
+  }
 
-    elements.reserve(bytes.size());
+  static k_value executeMapFile(const Token& token,
+                                const std::vector<k_value>& args) {
+    if (args.size() != 1) {
+      throw BuiltinUnexpectedArgumentError(token, FileIOBuiltIns.MapFile);
+    }
 
-    for (const auto& byte : bytes) {
-      elements.emplace_back(static_cast<k_int>(byte));
+    auto fileName = get_string(token, args.at(0));
+    auto bytes = MappedFile::map(fileName);
+    if (!bytes) {
+      throw FileReadError(token, fileName);
     }
 
-    return list;
+    return bytes;
   }
 
   static k_value executeWriteLine(const Token& token,
@@ -410,6 +565,10 @@ class FileIOBuiltinHandler {
       throw BuiltinUnexpectedArgumentError(token, FileIOBuiltIns.WriteLine);
     }
 
+    if (auto writer = get_writer(args.at(0))) {
+      return writeText(token, writer, args.at(1), true);
+    }
+
     auto fileName = get_string(token, args.at(0));
     auto value = args.at(1);
     return File::writeToFile(fileName, value, true, true);
@@ -421,6 +580,10 @@ class FileIOBuiltinHandler {
       throw BuiltinUnexpectedArgumentError(token, FileIOBuiltIns.WriteText);
     }
 
+    if (auto writer = get_writer(args.at(0))) {
+      return writeText(token, writer, args.at(1), false);
+    }
+
     auto fileName = get_string(token, args.at(0));
     auto value = args.at(1);
     return File::writeToFile(fileName, value, false, false);
@@ -432,15 +595,21 @@ class FileIOBuiltinHandler {
       throw BuiltinUnexpectedArgumentError(token, FileIOBuiltIns.WriteBytes);
     }
 
-    auto fileName = get_string(token, args.at(0));
+    auto writer = get_writer(args.at(0));
     auto value = args.at(1);
 
+    if (std::holds_alternative<k_bytes>(value)) {
+      const auto& bytes = std::get<k_bytes>(value);
+      return writeBytes(token, writer, args.at(0), bytes->data(),
+                        bytes->size());
+    }
+
     if (!std::holds_alternative<k_list>(value)) {
       throw ConversionError(token, "Expected a list of bytes to write.");
     }
 
-    auto elements = std::get<k_list>(value)->elements;
-    std::vector<char> bytes;
+    const auto& elements = std::get<k_list>(value)->view();
+    std::vector<uint8_t> bytes;
     bytes.reserve(elements.size());
 
     for (const auto& item : elements) {
@@ -448,10 +617,38 @@ class FileIOBuiltinHandler {
         throw ConversionError(token, "Expected a list of bytes to write.");
       }
 
-      bytes.emplace_back(static_cast<char>(std::get<k_int>(item)));
+      bytes.emplace_back(static_cast<uint8_t>(std::get<k_int>(item)));
+    }
+
+    return writeBytes(token, writer, args.at(0), bytes.data(), bytes.size());
+  }
+
+  static k_value writeBytes(const Token& token,
+                            const std::shared_ptr<FileWriter>& writer,
+                            const k_value& target, const uint8_t* data,
+                            size_t size) {
+    if (!writer) {
+      File::writeBytes(get_string(token, target), data, size);
+      return true;
+    }
+
+    if (!writer->write(reinterpret_cast<const char*>(data), size)) {
+      throw FileWriteError(token, writer->getPath());
+    }
+    return true;
+  }
+
+  static k_value writeText(const Token& token,
+                           const std::shared_ptr<FileWriter>& writer,
+                           const k_value& value, bool addNewLine) {
+    auto text = Serializer::serialize(value);
+    if (addNewLine) {
+      text.push_back('\n');
     }
 
-    File::writeBytes(fileName, bytes);
+    if (!writer->write(text)) {
+      throw FileWriteError(token, writer->getPath());
+    }
     return true;
   }
 };
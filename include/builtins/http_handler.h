@@ -151,8 +151,8 @@ class HttpBuiltinHandler {
   static httplib::Headers getHeaders(const k_hash& headersHash) {
     httplib::Headers headers;
 
-    for (const auto& key : headersHash->keys) {
-      const auto& value = headersHash->kvp[key];
+    for (const auto& key : headersHash->keys()) {
+      const auto& value = headersHash->view().at(key);
       headers.insert({key, Serializer::serialize(value)});
     }
 
@@ -49,7 +49,9 @@ class LoggingBuiltinHandler {
     }
 
     auto filePath = get_string(term, args.at(0));
-    Logger::getInstance().setLogFilePath(filePath);
+    if (!Logger::getInstance().setLogFilePath(filePath)) {
+      throw FileWriteError(term, filePath);
+    }
 
     return static_cast<k_int>(0);
   }
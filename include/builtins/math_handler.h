@@ -569,7 +569,7 @@ class MathBuiltinHandler {
 
     auto primes = PrimeGenerator::listPrimes(std::get<k_int>(args.at(0)));
     auto list = std::make_shared<List>();
-    auto& elements = list->elements;
+    auto& elements = list->elements();
 
     for (const auto& prime : primes) {
       elements.emplace_back(static_cast<k_int>(prime));
@@ -617,7 +617,7 @@ class MathBuiltinHandler {
     }
 
     auto list = std::make_shared<List>();
-    auto& elements = list->elements;
+    auto& elements = list->elements();
 
     for (const auto& divisor :
          MathImpl.__divisors__(std::get<k_int>(args.at(0)))) {
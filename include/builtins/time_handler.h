@@ -3,6 +3,7 @@
 
 #include <exception>
 #include <vector>
+#include "concurrency/scheduler.h"
 #include "math/functions.h"
 #include "parsing/builtins.h"
 #include "parsing/tokens.h"
@@ -77,7 +78,8 @@ class TimeBuiltinHandler {
     }
 
     int ms = static_cast<int>(get_double(term, args.at(0)));
-    return Time::delay(ms);
+    TaskScheduler::sleepFor(std::chrono::milliseconds(ms));
+    return static_cast<k_int>(ms);
   }
 
   static k_value executeEpochMilliseconds(const Token& term,
@@ -17,16 +17,20 @@
 #include "host.h"
 #include "stackframe.h"
 
+// Before `task`, whose workers may use them.
+ChannelRegistry channels;
+AtomicRegistry atomics;
+ConcurrentMapRegistry concurrentMaps;
 TaskManager task;
 
 std::unordered_map<std::string, Method> methods;
 std::unordered_map<std::string, Package> packages;
 std::unordered_map<std::string, Class> classes;
+std::atomic<uint64_t> classGeneration{0};
+std::shared_mutex definitionsMutex;
 std::unordered_map<std::string, std::string> kiwiArgs;
-std::stack<std::shared_ptr<CallStackFrame>> callStack;
-std::stack<k_stream> streamStack;
-std::stack<std::string> packageStack;
 std::unordered_map<int, Method> kiwiWebServerHooks;
+ExecutionContext::Pool kiwiWebServerContexts;  // Before the server using it.
 httplib::Server kiwiWebServer;
 std::string kiwiWebServerHost;
 k_int kiwiWebServerPort;
@@ -55,7 +59,11 @@ int KiwiCLI::run(int argc, char** argv) {
     args.emplace_back(argv[i]);
   }
 
-  return KiwiCLI::run(args);
+  auto code = KiwiCLI::run(args);
+
+  // Tasks nobody awaited still use the interpreter, which statics outlive.
+  task.waitForAll();
+  return code;
 }
 
 int KiwiCLI::run(std::vector<std::string>& v) {
@@ -74,6 +82,10 @@ int KiwiCLI::run(std::vector<std::string>& v) {
     for (size_t i = 1; i < size; ++i) {
       if (String::isCLIFlag(v.at(i), "h", "help")) {
         help = true;
+      } else if (String::isCLIFlag(v.at(i), "vm", "vm")) {
+        interp.enableVirtualMachine();
+      } else if (String::isCLIFlag(v.at(i), "vm-verify", "vm-verify")) {
+        interp.enableVirtualMachine(true);
       } else if (String::isCLIFlag(v.at(i), "v", "version")) {
         return KiwiCLI::printVersion();
       } else if (String::isCLIFlag(v.at(i), "n", "new")) {
@@ -231,6 +243,8 @@ int KiwiCLI::printHelp() {
       {"-m, --minify <input_file_path>", "create a `.min.🥝` file"},
       {"-t, --tokenize <input_file_path>",
        "tokenize a file with the kiwi lexer"},
+      {"--vm", "evaluate expressions on the bytecode VM"},
+      {"--vm-verify", "check the bytecode VM against the interpreter"},
       {"-X<key>=<value>", "specify an argument as a key-value pair"}};
 
 #ifdef _WIN64
@@ -241,6 +255,8 @@ int KiwiCLI::printHelp() {
       {"-n, --new <filename>", "create a `.kiwi` file"},
       {"-m, --minify <input_file_path>", "create a `.min.kiwi` file"},
       {"-t, --tokenize <input_file_path>", "tokenize a file as kiwi code"},
+      {"--vm", "evaluate expressions on the bytecode VM"},
+      {"--vm-verify", "check the bytecode VM against the interpreter"},
       {"-X<key>=<value>", "specify an argument as a key-value pair"}};
 #endif
 
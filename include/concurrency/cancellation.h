@@ -0,0 +1,132 @@
+#ifndef KIWI_CONCURRENCY_CANCELLATION_H
+#define KIWI_CONCURRENCY_CANCELLATION_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include "concurrency/fiber.h"
+
+// Thrown by a wait that noticed its task was cancelled.
+class TaskCancelled : public std::exception {
+ public:
+  const char* what() const noexcept override {
+    return "The task was cancelled.";
+  }
+};
+
+// Asks a task to stop. The task notices at safe points, between statements
+// and whenever it waits, and raises its cancellation there once. It may catch
+// it and carry on, say to clean up, and can be cancelled again.
+class CancellationToken {
+ public:
+  using Waker = std::function<void()>;
+
+  CancellationToken() {}
+
+  CancellationToken(const CancellationToken&) = delete;
+  CancellationToken& operator=(const CancellationToken&) = delete;
+
+  /// @brief Requests cancellation and wakes the task if it is sleeping.
+  void cancel() {
+    Waker wake;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (state.load(std::memory_order_relaxed) == Requested) {
+        return;
+      }
+      state.store(Requested, std::memory_order_release);
+      wake.swap(waker);
+    }
+    cancelled.notify_all();
+
+    if (wake) {
+      wake();
+    }
+  }
+
+  /// @brief Whether cancellation was requested and not yet raised.
+  bool isPending() const {
+    return state.load(std::memory_order_acquire) == Requested;
+  }
+
+  /// @brief Whether the task should raise its cancellation now. True once
+  /// per request. Cheap enough to call between statements.
+  bool take() {
+    if (state.load(std::memory_order_relaxed) != Requested) {
+      return false;
+    }
+
+    auto expected = Requested;
+    return state.compare_exchange_strong(expected, Raised,
+                                         std::memory_order_acq_rel);
+  }
+
+  /// @brief Has `wake` called on cancellation until `clearWaker`, or at once
+  /// if cancellation is already pending.
+  void setWaker(Waker wake) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (state.load(std::memory_order_relaxed) != Requested) {
+        waker = std::move(wake);
+        return;
+      }
+    }
+    wake();
+  }
+
+  void clearWaker() {
+    Waker dropped;  // Released outside the lock.
+    std::lock_guard<std::mutex> lock(mutex);
+    dropped.swap(waker);
+  }
+
+  /// @brief Blocks the thread for `duration`, or until cancelled.
+  void sleepFor(std::chrono::milliseconds duration) {
+    std::unique_lock<std::mutex> lock(mutex);
+    cancelled.wait_for(lock, duration, [this]() { return isPending(); });
+  }
+
+  /// @brief The token of the task running on this fiber or thread, if any.
+  static CancellationToken* current() {
+    return static_cast<CancellationToken*>(
+        Fiber::local(Fiber::Local::Cancellation));
+  }
+
+  /// @brief Throws `TaskCancelled` if the running task should raise its
+  /// cancellation now.
+  static void check() {
+    auto token = current();
+    if (token && token->take()) {
+      throw TaskCancelled();
+    }
+  }
+
+  // Makes a token the current one until the scope exits.
+  class Scope {
+   public:
+    explicit Scope(CancellationToken* token)
+        : previous(Fiber::local(Fiber::Local::Cancellation)) {
+      Fiber::local(Fiber::Local::Cancellation) = token;
+    }
+    ~Scope() { Fiber::local(Fiber::Local::Cancellation) = previous; }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    void* previous;
+  };
+
+ private:
+  enum State { None, Requested, Raised };
+
+  std::atomic<State> state{None};
+  std::mutex mutex;
+  std::condition_variable cancelled;
+  Waker waker;  // Guarded by `mutex`.
+};
+
+#endif
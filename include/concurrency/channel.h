@@ -0,0 +1,136 @@
+#ifndef KIWI_CONCURRENCY_CHANNEL_H
+#define KIWI_CONCURRENCY_CHANNEL_H
+
+#include <atomic>
+#include <memory>
+#include <shared_mutex>
+#include <vector>
+#include "typing/value.h"
+
+// A bounded multi-producer, multi-consumer queue. Each cell carries a
+// sequence number that tells producers and consumers whose turn it is, so
+// `trySend` and `tryRecv` never lock. Blocking is left to the caller.
+class Channel {
+ public:
+  explicit Channel(size_t capacity)
+      : capacity(capacity), cells(new Cell[capacity]) {
+    for (size_t i = 0; i < capacity; ++i) {
+      cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  Channel(const Channel&) = delete;
+  Channel& operator=(const Channel&) = delete;
+
+  /// @brief Queues a value unless the channel is full or closed. The value
+  /// is only moved from on success.
+  bool trySend(k_value& value) {
+    if (closed.load(std::memory_order_acquire)) {
+      return false;
+    }
+
+    auto position = sendPosition.load(std::memory_order_relaxed);
+    while (true) {
+      auto& cell = cells[position % capacity];
+      auto sequence = cell.sequence.load(std::memory_order_acquire);
+      auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+
+      if (difference == 0) {
+        if (sendPosition.compare_exchange_weak(position, position + 1,
+                                               std::memory_order_relaxed)) {
+          cell.value = std::move(value);
+          cell.sequence.store(position + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (difference < 0) {
+        return false;  // Full.
+      } else {
+        position = sendPosition.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /// @brief Takes the oldest value, if there is one.
+  bool tryRecv(k_value& value) {
+    auto position = recvPosition.load(std::memory_order_relaxed);
+    while (true) {
+      auto& cell = cells[position % capacity];
+      auto sequence = cell.sequence.load(std::memory_order_acquire);
+      auto difference =
+          static_cast<std::ptrdiff_t>(sequence - (position + 1));
+
+      if (difference == 0) {
+        if (recvPosition.compare_exchange_weak(position, position + 1,
+                                               std::memory_order_relaxed)) {
+          value = std::move(cell.value);
+          cell.value = {};
+          cell.sequence.store(position + capacity, std::memory_order_release);
+          return true;
+        }
+      } else if (difference < 0) {
+        return false;  // Empty.
+      } else {
+        position = recvPosition.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /// @brief Takes the oldest value, or reports that none will ever come.
+  /// @return True if `value` was set or `drained` became true.
+  bool tryRecvOrDrained(k_value& value, bool& drained) {
+    // Read before receiving: a send that beat the close is still taken.
+    auto wasClosed = isClosed();
+    if (tryRecv(value)) {
+      return true;
+    }
+
+    drained = wasClosed;
+    return wasClosed;
+  }
+
+  void close() { closed.store(true, std::memory_order_release); }
+
+  bool isClosed() const { return closed.load(std::memory_order_acquire); }
+
+  size_t getCapacity() const { return capacity; }
+
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    k_value value;
+  };
+
+  const size_t capacity;
+  std::unique_ptr<Cell[]> cells;
+
+  // Apart, so producers and consumers don't contend for one cache line.
+  alignas(64) std::atomic<size_t> sendPosition{0};
+  alignas(64) std::atomic<size_t> recvPosition{0};
+  std::atomic<bool> closed{false};
+};
+
+// Channels by ID. A channel lives as long as the process, since any task
+// holding its ID may still use it.
+class ChannelRegistry {
+ public:
+  k_int create(size_t capacity) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    channels.push_back(std::make_shared<Channel>(capacity));
+    return static_cast<k_int>(channels.size() - 1);
+  }
+
+  /// @brief The channel with an ID, or null if there is none.
+  std::shared_ptr<Channel> get(k_int id) {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    if (id < 0 || id >= static_cast<k_int>(channels.size())) {
+      return nullptr;
+    }
+    return channels[id];
+  }
+
+ private:
+  std::shared_mutex mutex;
+  std::vector<std::shared_ptr<Channel>> channels;
+};
+
+#endif
@@ -0,0 +1,155 @@
+#ifndef KIWI_CONCURRENCY_CONCURRENT_H
+#define KIWI_CONCURRENCY_CONCURRENT_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "typing/value.h"
+
+// A hash map that tasks share. Keys are spread over shards, each with a lock
+// of its own, so tasks working on different keys rarely wait on each other.
+// Values are copied in and out, so no task holds a reference into the map.
+class ConcurrentMap {
+ public:
+  static constexpr size_t ShardCount = 32;
+
+  ConcurrentMap() {}
+
+  ConcurrentMap(const ConcurrentMap&) = delete;
+  ConcurrentMap& operator=(const ConcurrentMap&) = delete;
+
+  /// @brief Copies the value of a key into `value`, if there is one.
+  bool get(const k_string& key, k_value& value) {
+    auto& shard = getShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.values.find(key);
+    if (it == shard.values.end()) {
+      return false;
+    }
+
+    value = clone_value(it->second);
+    return true;
+  }
+
+  void set(const k_string& key, const k_value& value) {
+    auto copy = clone_value(value);  // Outside the lock.
+    auto& shard = getShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.values[key] = std::move(copy);
+  }
+
+  /// @brief Runs `update` on the value of a key while its shard is locked.
+  /// A missing key is passed as `false` and added only if `update` returns
+  /// true. `update` must not touch the map.
+  /// @return A copy of the value after the update.
+  k_value update(const k_string& key,
+                 const std::function<bool(k_value&, bool)>& update) {
+    auto& shard = getShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.values.find(key);
+    if (it != shard.values.end()) {
+      update(it->second, true);
+      return clone_value(it->second);
+    }
+
+    k_value value;
+    if (update(value, false)) {
+      auto result = clone_value(value);
+      shard.values.emplace(key, std::move(value));
+      return result;
+    }
+    return value;
+  }
+
+  bool remove(const k_string& key) {
+    auto& shard = getShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.values.erase(key) > 0;
+  }
+
+  bool has(const k_string& key) {
+    auto& shard = getShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.values.find(key) != shard.values.end();
+  }
+
+  /// @brief The number of keys. Shards are counted one at a time, so the
+  /// result may be stale while other tasks write.
+  size_t size() {
+    size_t count = 0;
+    for (auto& shard : shards) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      count += shard.values.size();
+    }
+    return count;
+  }
+
+  /// @brief Copies every key and value, a shard at a time.
+  std::vector<std::pair<k_string, k_value>> snapshot() {
+    std::vector<std::pair<k_string, k_value>> entries;
+    for (auto& shard : shards) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      for (const auto& entry : shard.values) {
+        entries.emplace_back(entry.first, clone_value(entry.second));
+      }
+    }
+    return entries;
+  }
+
+  void clear() {
+    for (auto& shard : shards) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      shard.values.clear();
+    }
+  }
+
+ private:
+  // Each on its own cache line, so locking one doesn't slow its neighbours.
+  struct alignas(64) Shard {
+    std::mutex mutex;
+    std::unordered_map<k_string, k_value> values;
+  };
+
+  Shard shards[ShardCount];
+
+  Shard& getShard(const k_string& key) {
+    return shards[std::hash<k_string>()(key) % ShardCount];
+  }
+};
+
+// Shared objects by ID. An object lives as long as the process, since any
+// task holding its ID may still use it.
+template <typename T>
+class ConcurrentRegistry {
+ public:
+  template <typename... Args>
+  k_int create(Args&&... args) {
+    auto object = std::make_shared<T>(std::forward<Args>(args)...);
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    objects.push_back(std::move(object));
+    return static_cast<k_int>(objects.size() - 1);
+  }
+
+  /// @brief The object with an ID, or null if there is none.
+  std::shared_ptr<T> get(k_int id) {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    if (id < 0 || id >= static_cast<k_int>(objects.size())) {
+      return nullptr;
+    }
+    return objects[id];
+  }
+
+ private:
+  std::shared_mutex mutex;
+  std::vector<std::shared_ptr<T>> objects;
+};
+
+using AtomicRegistry = ConcurrentRegistry<std::atomic<k_int>>;
+using ConcurrentMapRegistry = ConcurrentRegistry<ConcurrentMap>;
+
+#endif
@@ -0,0 +1,204 @@
+#ifndef KIWI_CONCURRENCY_FIBER_H
+#define KIWI_CONCURRENCY_FIBER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <functional>
+#include <memory>
+
+#ifndef _WIN64
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+#endif
+
+#if defined(__SANITIZE_THREAD__)
+#include <sanitizer/tsan_interface.h>
+#define KIWI_TSAN_FIBERS
+#endif
+
+#if defined(__SANITIZE_ADDRESS__)
+#include <sanitizer/common_interface_defs.h>
+#define KIWI_ASAN_FIBERS
+#endif
+
+#ifdef _WIN64
+
+// Fibers are not supported on Windows yet. Jobs run on their thread's stack
+// and waits block the thread.
+class Fiber {
+ public:
+  using Body = std::function<void()>;
+
+  enum class Local { Context, Cancellation, Count };
+
+  static std::unique_ptr<Fiber> create() { return nullptr; }
+  static Fiber* current() { return nullptr; }
+  static void suspend() {}
+
+  static void*& local(Local slot = Local::Context) {
+    static thread_local void* threadLocals[size_t(Local::Count)] = {};
+    return threadLocals[size_t(slot)];
+  }
+
+  void start(Body) {}
+  bool resume() { return true; }
+};
+
+#else
+
+// A body of work with a stack of its own. It runs on the thread that resumes
+// it until it returns or suspends itself, and then picks up where it left off
+// on the next resume. Callers always resume a fiber from the same thread.
+class Fiber {
+ public:
+  using Body = std::function<void()>;
+
+  // Pointers kept per fiber, by the code that runs on them.
+  enum class Local { Context, Cancellation, Count };
+
+  // As much as a thread gets. Pages are only committed once touched.
+  static constexpr size_t StackSize = 8 * 1024 * 1024;
+
+  /// @brief Maps a stack for a new fiber.
+  /// @return The fiber, or null if the stack could not be mapped.
+  static std::unique_ptr<Fiber> create() {
+    auto guard = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    auto size = StackSize + guard;
+    auto memory = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (memory == MAP_FAILED) {
+      return nullptr;
+    }
+
+    // An overflow faults on the guard page rather than corrupt memory.
+    if (mprotect(memory, guard, PROT_NONE) != 0) {
+      munmap(memory, size);
+      return nullptr;
+    }
+
+    return std::unique_ptr<Fiber>(new Fiber(memory, size, guard));
+  }
+
+  ~Fiber() {
+#ifdef KIWI_TSAN_FIBERS
+    __tsan_destroy_fiber(tsanFiber);
+#endif
+    munmap(memory, size);
+  }
+
+  Fiber(const Fiber&) = delete;
+  Fiber& operator=(const Fiber&) = delete;
+
+  /// @brief The fiber running on this thread, if any.
+  static Fiber* current() { return running; }
+
+  /// @brief A pointer that belongs to the running fiber, or to the thread
+  /// when no fiber runs. State kept here follows a fiber across switches.
+  static void*& local(Local slot = Local::Context) {
+    static thread_local void* threadLocals[size_t(Local::Count)] = {};
+    return running ? running->fiberLocals[size_t(slot)]
+                   : threadLocals[size_t(slot)];
+  }
+
+  /// @brief Sets the body for the next resume. The fiber must not be
+  /// running or suspended, and `body` must not throw.
+  void start(Body next) {
+    body = std::move(next);
+    finished = false;
+    std::fill(std::begin(fiberLocals), std::end(fiberLocals), nullptr);
+
+    getcontext(&context);
+    context.uc_stack.ss_sp = static_cast<char*>(memory) + guard;
+    context.uc_stack.ss_size = size - guard;
+    context.uc_link = nullptr;
+
+    // `makecontext` only passes ints, so the pointer goes in two halves.
+    auto self = reinterpret_cast<std::uintptr_t>(this);
+    makecontext(&context, reinterpret_cast<void (*)()>(&Fiber::entry), 2,
+                static_cast<unsigned>(self >> 32),
+                static_cast<unsigned>(self & 0xffffffffu));
+  }
+
+  /// @brief Runs the fiber until its body returns or it suspends.
+  /// @return True if the body returned.
+  bool resume() {
+    auto previous = running;
+    running = this;
+#ifdef KIWI_TSAN_FIBERS
+    callerTsanFiber = __tsan_get_current_fiber();
+    __tsan_switch_to_fiber(tsanFiber, 0);
+#endif
+#ifdef KIWI_ASAN_FIBERS
+    void* fakeStack = nullptr;
+    __sanitizer_start_switch_fiber(&fakeStack, context.uc_stack.ss_sp,
+                                   context.uc_stack.ss_size);
+#endif
+    swapcontext(&caller, &context);
+#ifdef KIWI_ASAN_FIBERS
+    __sanitizer_finish_switch_fiber(fakeStack, nullptr, nullptr);
+#endif
+    running = previous;
+    return finished;
+  }
+
+  /// @brief Switches from the running fiber back to whoever resumed it.
+  static void suspend() {
+    auto self = running;
+#ifdef KIWI_TSAN_FIBERS
+    __tsan_switch_to_fiber(self->callerTsanFiber, 0);
+#endif
+#ifdef KIWI_ASAN_FIBERS
+    // A finished fiber passes no fake stack, so its own is released.
+    void* fakeStack = nullptr;
+    __sanitizer_start_switch_fiber(self->finished ? nullptr : &fakeStack,
+                                   self->callerStack, self->callerStackSize);
+#endif
+    swapcontext(&self->context, &self->caller);
+#ifdef KIWI_ASAN_FIBERS
+    __sanitizer_finish_switch_fiber(fakeStack, &self->callerStack,
+                                    &self->callerStackSize);
+#endif
+  }
+
+ private:
+  void* memory;
+  size_t size;
+  size_t guard;
+  ucontext_t context;
+  ucontext_t caller;
+  Body body;
+  bool finished = true;
+  void* fiberLocals[size_t(Local::Count)] = {};
+#ifdef KIWI_TSAN_FIBERS
+  void* tsanFiber = __tsan_create_fiber(0);
+  void* callerTsanFiber = nullptr;
+#endif
+#ifdef KIWI_ASAN_FIBERS
+  const void* callerStack = nullptr;
+  size_t callerStackSize = 0;
+#endif
+
+  static inline thread_local Fiber* running = nullptr;
+
+  Fiber(void* memory, size_t size, size_t guard)
+      : memory(memory), size(size), guard(guard) {}
+
+  static void entry(unsigned high, unsigned low) {
+    auto self = reinterpret_cast<Fiber*>(
+        (static_cast<std::uintptr_t>(high) << 32) | low);
+#ifdef KIWI_ASAN_FIBERS
+    __sanitizer_finish_switch_fiber(nullptr, &self->callerStack,
+                                    &self->callerStackSize);
+#endif
+    self->body();
+    self->body = nullptr;
+    self->finished = true;
+    suspend();  // Never resumed again until restarted.
+  }
+};
+
+#endif
+
+#endif
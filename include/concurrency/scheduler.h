@@ -0,0 +1,473 @@
+#ifndef KIWI_CONCURRENCY_SCHEDULER_H
+#define KIWI_CONCURRENCY_SCHEDULER_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "concurrency/cancellation.h"
+#include "concurrency/fiber.h"
+#include "concurrency/timer.h"
+
+// A pool of workers, one per hardware thread. Each worker has its own deque:
+// it pushes and pops work at the back and, when empty, steals from the front
+// of the others. Jobs submitted from outside the pool go to a shared queue.
+//
+// Workers run each job on a fiber. A job that has to wait suspends its fiber
+// instead of its thread, and the worker moves on to other jobs. Whatever the
+// job waits on wakes it through a `Waker`, and it resumes on the same worker.
+// A job that can't suspend, such as one on a spare thread, marks itself
+// `Blocking` while it waits. If every thread of the pool is blocked while
+// jobs are queued, a spare thread is started to run them, and it exits once
+// the queues are empty.
+class TaskScheduler {
+ public:
+  using Job = std::function<void()>;
+  using Clock = TimerWheel::Clock;
+
+ private:
+  struct Worker;
+
+ public:
+  // Resumes a suspended job. Whatever the job waits on holds a waker, and
+  // may share it with others, such as a timer for a timeout. Only the first
+  // `wake` counts.
+  class Waker : public std::enable_shared_from_this<Waker> {
+   public:
+    Waker(TaskScheduler* scheduler, Worker* worker)
+        : scheduler(scheduler), worker(worker) {}
+
+    void wake() {
+      if (armed.exchange(false)) {
+        scheduler->resume(shared_from_this());
+      }
+    }
+
+   private:
+    friend class TaskScheduler;
+    TaskScheduler* scheduler;
+    Worker* worker;
+    std::unique_ptr<Fiber> fiber;  // Set by its worker once suspended.
+    std::atomic<bool> armed{true};
+  };
+
+  TaskScheduler() {}
+  ~TaskScheduler() { stop(); }
+
+  TaskScheduler(const TaskScheduler&) = delete;
+  TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+  void submit(Job job) {
+    start();
+
+    // Counted before it is queued so the count never drops below zero.
+    ++pending;
+    if (currentWorker && currentWorker->owner == this) {
+      std::lock_guard<std::mutex> lock(currentWorker->mutex);
+      currentWorker->jobs.push_back(std::move(job));
+    } else {
+      std::lock_guard<std::mutex> lock(injectedMutex);
+      injected.push_back(std::move(job));
+    }
+
+    { std::lock_guard<std::mutex> lock(idleMutex); }
+    idle.notify_one();
+
+    ensureRunner();
+  }
+
+  /// @brief Whether the calling code runs on a worker's fiber and so can
+  /// suspend rather than block.
+  static bool canSuspend() { return currentWorker && Fiber::current(); }
+
+  /// @brief Prepares the calling job to suspend. The caller hands the waker
+  /// to whatever it waits on and then calls `suspend`.
+  /// @return The waker, or null if the job can't suspend and has to block.
+  static std::shared_ptr<Waker> prepareSuspend() {
+    if (!canSuspend()) {
+      return nullptr;
+    }
+
+    auto worker = currentWorker;
+    worker->suspending = std::make_shared<Waker>(worker->owner, worker);
+    return worker->suspending;
+  }
+
+  /// @brief Suspends the calling job until its waker is woken.
+  static void suspend() { Fiber::suspend(); }
+
+  /// @brief Runs `callback` on the timer thread at `deadline`. It should
+  /// only hand work elsewhere, such as to `submit`.
+  /// @return An ID for `cancelTimer`.
+  TimerWheel::Id addTimer(Clock::time_point deadline,
+                          TimerWheel::Callback callback) {
+    return timers.add(deadline, std::move(callback));
+  }
+
+  /// @brief Drops a timer that has not run yet.
+  /// @return True if it was pending.
+  bool cancelTimer(TimerWheel::Id id) { return timers.cancel(id); }
+
+  /// @brief Wakes `waker` at `deadline`.
+  /// @return An ID for `cancelTimer`, for when the wait ends sooner.
+  TimerWheel::Id wakeAt(Clock::time_point deadline,
+                        std::shared_ptr<Waker> waker) {
+    return addTimer(deadline, [waker = std::move(waker)]() { waker->wake(); });
+  }
+
+  /// @brief Waits for `duration`. A job on a fiber suspends meanwhile and
+  /// frees its worker; anything else blocks its thread. Cancelling the
+  /// running task cuts the wait short and throws `TaskCancelled`.
+  static void sleepFor(std::chrono::milliseconds duration) {
+    CancellationToken::check();
+    auto token = CancellationToken::current();
+
+    if (auto waker = prepareSuspend()) {
+      auto scheduler = waker->scheduler;
+      auto timer = scheduler->wakeAt(Clock::now() + duration, waker);
+      if (token) {
+        token->setWaker([waker]() { waker->wake(); });
+      }
+
+      suspend();
+
+      if (token) {
+        token->clearWaker();
+      }
+      scheduler->cancelTimer(timer);
+      CancellationToken::check();
+      return;
+    }
+
+    Blocking blocking;  // Lets queued jobs run meanwhile.
+    if (token) {
+      token->sleepFor(duration);
+    } else {
+      std::this_thread::sleep_for(duration);
+    }
+    CancellationToken::check();
+  }
+
+  // Marks the calling thread as waiting until the scope exits. Has no effect
+  // on threads outside a pool.
+  class Blocking {
+   public:
+    Blocking() : scheduler(poolOwner) {
+      if (scheduler) {
+        ++scheduler->blocked;
+        scheduler->ensureRunner();
+      }
+    }
+    ~Blocking() {
+      if (scheduler) {
+        --scheduler->blocked;
+      }
+    }
+
+    Blocking(const Blocking&) = delete;
+    Blocking& operator=(const Blocking&) = delete;
+
+   private:
+    TaskScheduler* scheduler;
+  };
+
+  size_t getWorkerCount() {
+    start();
+    return workers.size();
+  }
+
+  /// @brief Runs the queued jobs to completion, then joins the workers. Jobs
+  /// still suspended are dropped.
+  void stop() {
+    {
+      std::lock_guard<std::mutex> lock(idleMutex);
+      if (stopping) {
+        return;
+      }
+      stopping = true;
+    }
+    idle.notify_all();
+
+    for (auto& worker : workers) {
+      join(worker->thread);
+    }
+
+    // Moved out, since a spare's job may still need the lock to start one.
+    std::vector<std::unique_ptr<Spare>> stopped;
+    {
+      std::lock_guard<std::mutex> lock(sparesMutex);
+      stopped.swap(spares);
+    }
+    for (auto& spare : stopped) {
+      join(spare->thread);
+    }
+
+    timers.stop();
+  }
+
+ private:
+  // Enough to start most jobs without mapping a stack.
+  static constexpr size_t IdleFibersPerWorker = 16;
+
+  struct Worker {
+    TaskScheduler* owner;
+    std::mutex mutex;
+    std::deque<Job> jobs;
+    std::deque<std::shared_ptr<Waker>> resumed;  // Guarded by `mutex`.
+    std::atomic<size_t> resumable{0};
+    std::shared_ptr<Waker> suspending;  // Only used by its own thread.
+    std::vector<std::unique_ptr<Fiber>> fibers;  // Idle, for reuse.
+    std::thread thread;
+  };
+
+  std::vector<std::unique_ptr<Worker>> workers;
+  std::once_flag started;
+
+  std::mutex injectedMutex;
+  std::deque<Job> injected;
+
+  struct Spare {
+    std::thread thread;
+    std::atomic<bool> done{false};
+  };
+
+  std::mutex sparesMutex;
+  std::vector<std::unique_ptr<Spare>> spares;
+
+  std::mutex idleMutex;
+  std::condition_variable idle;
+  std::atomic<size_t> pending{0};
+  std::atomic<size_t> running{0};  // Workers and spares.
+  std::atomic<size_t> blocked{0};  // Of those, the ones in `Blocking`.
+  bool stopping = false;
+
+  TimerWheel timers;
+
+  static inline thread_local Worker* currentWorker = nullptr;
+  static inline thread_local TaskScheduler* poolOwner = nullptr;
+
+  void start() {
+    std::call_once(started, [this]() {
+      auto count = std::max(1u, std::thread::hardware_concurrency());
+      for (unsigned i = 0; i < count; ++i) {
+        workers.emplace_back(std::make_unique<Worker>());
+        workers.back()->owner = this;
+      }
+      running = count;
+
+      // Start threads only once every deque exists, since they steal.
+      for (auto& worker : workers) {
+        auto self = worker.get();
+        worker->thread = std::thread([this, self]() { work(self); });
+      }
+    });
+  }
+
+  /// @brief Queues a woken job on the worker it suspended on. Only that
+  /// worker resumes it, and only once it has finished suspending.
+  void resume(std::shared_ptr<Waker> waker) {
+    auto worker = waker->worker;
+    {
+      std::lock_guard<std::mutex> lock(worker->mutex);
+      worker->resumed.push_back(std::move(waker));
+      ++worker->resumable;
+    }
+
+    { std::lock_guard<std::mutex> lock(idleMutex); }
+    idle.notify_all();  // Any worker may be the one waiting.
+  }
+
+  bool needsRunner() const {
+    return pending.load() > 0 && blocked.load() >= running.load();
+  }
+
+  /// @brief Starts a spare thread if jobs are queued and every thread of the
+  /// pool is blocked.
+  void ensureRunner() {
+    if (!needsRunner()) {
+      return;
+    }
+
+    std::lock_guard<std::mutex> lock(sparesMutex);
+    if (!needsRunner()) {
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> idleLock(idleMutex);
+      if (stopping) {
+        return;
+      }
+    }
+
+    // Reap spares that have exited.
+    for (auto it = spares.begin(); it != spares.end();) {
+      if ((*it)->done.load()) {
+        (*it)->thread.join();
+        it = spares.erase(it);
+      } else {
+        ++it;
+      }
+    }
+
+    ++running;
+    spares.emplace_back(std::make_unique<Spare>());
+    auto self = spares.back().get();
+    self->thread = std::thread([this, self]() { spare(self); });
+  }
+
+  void spare(Spare* self) {
+    poolOwner = this;
+
+    while (true) {
+      Job job;
+      if (take(job)) {
+        job();
+        continue;
+      }
+
+      // Checked after leaving, since a job may have been queued meanwhile.
+      --running;
+      if (!needsRunner()) {
+        break;
+      }
+      ++running;
+    }
+
+    self->done = true;
+  }
+
+  void join(std::thread& thread) {
+    if (!thread.joinable()) {
+      return;
+    }
+
+    if (thread.get_id() == std::this_thread::get_id()) {
+      thread.detach();  // Stopped from one of its own jobs.
+    } else {
+      thread.join();
+    }
+  }
+
+  void work(Worker* self) {
+    currentWorker = self;
+    poolOwner = this;
+
+    while (true) {
+      std::shared_ptr<Waker> waker;
+      if (takeResumed(self, waker)) {
+        runFiber(self, std::move(waker->fiber));
+        continue;
+      }
+
+      Job job;
+      if (take(job)) {
+        runJob(self, std::move(job));
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock(idleMutex);
+      idle.wait(lock, [this, self]() {
+        return stopping || pending.load() > 0 || self->resumable.load() > 0;
+      });
+      if (stopping && pending.load() == 0 && self->resumable.load() == 0) {
+        return;
+      }
+    }
+  }
+
+  void runJob(Worker* self, Job job) {
+    std::unique_ptr<Fiber> fiber;
+    if (!self->fibers.empty()) {
+      fiber = std::move(self->fibers.back());
+      self->fibers.pop_back();
+    } else {
+      fiber = Fiber::create();
+    }
+
+    if (!fiber) {
+      job();  // Out of stacks, so this one can only block.
+      return;
+    }
+
+    fiber->start(std::move(job));
+    runFiber(self, std::move(fiber));
+  }
+
+  void runFiber(Worker* self, std::unique_ptr<Fiber> fiber) {
+    if (!fiber->resume()) {
+      // Suspended. Its waker keeps it until woken.
+      auto waker = std::move(self->suspending);
+      waker->fiber = std::move(fiber);
+      return;
+    }
+
+    if (self->fibers.size() < IdleFibersPerWorker) {
+      self->fibers.push_back(std::move(fiber));
+    }
+  }
+
+  bool takeResumed(Worker* self, std::shared_ptr<Waker>& waker) {
+    if (self->resumable.load() == 0) {
+      return false;
+    }
+
+    std::lock_guard<std::mutex> lock(self->mutex);
+    waker = std::move(self->resumed.front());
+    self->resumed.pop_front();
+    --self->resumable;
+    return true;
+  }
+
+  bool take(Job& job) {
+    if (pending.load() == 0) {
+      return false;
+    }
+
+    // Own work first, newest first.
+    if (currentWorker && currentWorker->owner == this) {
+      std::lock_guard<std::mutex> lock(currentWorker->mutex);
+      if (!currentWorker->jobs.empty()) {
+        job = std::move(currentWorker->jobs.back());
+        currentWorker->jobs.pop_back();
+        --pending;
+        return true;
+      }
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(injectedMutex);
+      if (!injected.empty()) {
+        job = std::move(injected.front());
+        injected.pop_front();
+        --pending;
+        return true;
+      }
+    }
+
+    // Steal the oldest job of another worker.
+    for (auto& worker : workers) {
+      if (worker.get() == currentWorker) {
+        continue;
+      }
+
+      std::lock_guard<std::mutex> lock(worker->mutex);
+      if (!worker->jobs.empty()) {
+        job = std::move(worker->jobs.front());
+        worker->jobs.pop_front();
+        --pending;
+        return true;
+      }
+    }
+
+    return false;
+  }
+};
+
+#endif
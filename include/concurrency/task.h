@@ -1,10 +1,20 @@
 #ifndef KIWI_CONCURRENCY_TASK_H
 #define KIWI_CONCURRENCY_TASK_H
 
+#include <condition_variable>
+#include <exception>
 #include <functional>
-#include <future>
-#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
 #include <atomic>
+#include <chrono>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include "concurrency/cancellation.h"
+#include "concurrency/scheduler.h"
 #include "typing/value.h"
 
 class TaskManager {
@@ -12,35 +22,425 @@ class TaskManager {
   using TaskFunction = std::function<k_value()>;
 
  private:
-  std::atomic<k_int> nextPromiseId;
-  std::unordered_map<k_int, std::future<k_value>> tasks;
+  // A task ID indexes a slot. The slot is released when the task is awaited,
+  // and its ID is handed to the next task.
+  struct Slot {
+    bool inUse = false;
+    bool done = false;
+    size_t finishOrder = 0;
+    k_value result;
+    std::exception_ptr error;
+    std::shared_ptr<CancellationToken> token;
+  };
+
+  TaskScheduler scheduler;
+  std::mutex mutex;
+  std::condition_variable completed;
+  std::vector<Slot> slots;
+  std::vector<k_int> freeIds;
+  size_t finishedTasks = 0;
+  std::atomic<size_t> activeTasks{0};
+  std::atomic<size_t> waiters{0};
+  std::vector<std::shared_ptr<TaskScheduler::Waker>> parked;  // Suspended.
+
+  // Jobs run on a timer. A periodic one is armed again each time it fires.
+  struct Schedule {
+    std::function<void()> job;
+    TaskScheduler::Clock::duration period;  // Zero for a single run.
+    TaskScheduler::Clock::time_point deadline;
+    TimerWheel::Id timer = 0;
+    std::atomic<bool> running{false};
+  };
+
+  std::mutex schedulesMutex;
+  std::unordered_map<k_int, std::shared_ptr<Schedule>> schedules;
+  k_int nextScheduleId = 0;
 
  public:
-  TaskManager() : nextPromiseId(0) {}
+  TaskManager() {}
+  ~TaskManager() { scheduler.stop(); }  // Workers still use the slots.
 
   k_int addTask(TaskFunction func) {
-    k_int id = nextPromiseId++;
-    tasks[id] = std::async(std::launch::async, func);
+    auto token = std::make_shared<CancellationToken>();
+    k_int id;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!freeIds.empty()) {
+        id = freeIds.back();
+        freeIds.pop_back();
+      } else {
+        id = static_cast<k_int>(slots.size());
+        slots.emplace_back();
+      }
+      slots[id].inUse = true;
+      slots[id].token = token;
+    }
+
+    ++activeTasks;
+    scheduler.submit([this, id, token, func = std::move(func)]() {
+      k_value result;
+      std::exception_ptr error;
+      try {
+        CancellationToken::Scope scope(token.get());
+        result = func();
+      } catch (...) {
+        error = std::current_exception();
+      }
+
+      std::vector<std::shared_ptr<TaskScheduler::Waker>> woken;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& slot = slots[id];
+        slot.done = true;
+        slot.finishOrder = ++finishedTasks;
+        slot.result = std::move(result);
+        slot.error = std::move(error);  // Keeps no reference past the lock.
+        --activeTasks;  // Under the lock, so `waitForAll` can't miss it.
+        woken.swap(parked);
+      }
+      wakeAll(woken);
+    });
+
+    return id;
+  }
+
+  /// @brief Asks a task to stop. It raises its cancellation at the next
+  /// safe point, and any wait it is in is cut short.
+  /// @return False if the task had already finished.
+  bool cancel(k_int id) {
+    std::shared_ptr<CancellationToken> token;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      auto& slot = getSlot(id);
+      if (slot.done) {
+        return false;
+      }
+      token = slot.token;
+    }
+
+    token->cancel();
+    notify();  // So it stops waiting on other tasks or on channels.
+    return true;
+  }
+
+  /// @brief Runs `job` on the pool without a slot, for work nobody awaits.
+  /// `waitForAll` still waits for it. `job` must not throw.
+  void post(std::function<void()> job) {
+    ++activeTasks;
+    scheduler.submit([this, job = std::move(job)]() {
+      job();
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        --activeTasks;
+      }
+      completed.notify_all();
+    });
+  }
+
+  /// @brief Posts `job` after `delay`, and then every `period` if it is
+  /// positive. A run that comes due while the last one is still going is
+  /// skipped. Schedules don't keep the process alive. `job` must not throw.
+  /// @return An ID for `cancelSchedule`.
+  k_int schedule(TaskScheduler::Clock::duration delay,
+                 TaskScheduler::Clock::duration period,
+                 std::function<void()> job) {
+    auto entry = std::make_shared<Schedule>();
+    entry->job = std::move(job);
+    entry->period = period;
+    entry->deadline = TaskScheduler::Clock::now() + delay;
+
+    std::lock_guard<std::mutex> lock(schedulesMutex);
+    auto id = nextScheduleId++;
+    schedules[id] = entry;
+    arm(id, *entry);
     return id;
   }
 
-  k_value getTaskResult(k_int id) { return tasks.at(id).get(); }
+  /// @brief Stops a schedule. A run already started is left to finish.
+  /// @return True if the schedule was active.
+  bool cancelSchedule(k_int id) {
+    std::lock_guard<std::mutex> lock(schedulesMutex);
+    auto it = schedules.find(id);
+    if (it == schedules.end()) {
+      return false;
+    }
+
+    scheduler.cancelTimer(it->second->timer);
+    schedules.erase(it);
+    return true;
+  }
+
+  /// @brief Waits for a task and releases its ID.
+  k_value getTaskResult(k_int id) {
+    std::vector<k_int> ids = {id};
+    return std::move(awaitAll(ids, std::nullopt)->front());
+  }
+
+  /// @brief Waits for every task in `ids` and releases them.
+  /// @return The results in the order of `ids`, or nothing if the timeout
+  /// passes first. Nothing is released on timeout, so the tasks can be
+  /// awaited again.
+  std::optional<std::vector<k_value>> awaitAll(
+      const std::vector<k_int>& ids, std::optional<k_int> timeoutMs) {
+    auto lock = waitFor(ids, timeoutMs, [this, &ids]() {
+      for (const auto& id : ids) {
+        if (!slots[id].done) {
+          return false;
+        }
+      }
+      return true;
+    });
+
+    if (!lock) {
+      return std::nullopt;
+    }
+
+    // Release every task before rethrowing the first error, so none leak.
+    std::vector<k_value> results;
+    std::exception_ptr error;
+    for (const auto& id : ids) {
+      try {
+        results.push_back(release(id));
+      } catch (...) {
+        if (!error) {
+          error = std::current_exception();
+        }
+        results.emplace_back();
+      }
+    }
+
+    if (error) {
+      std::rethrow_exception(error);
+    }
+    return results;
+  }
+
+  /// @brief Waits for the first task in `ids` to finish and releases it.
+  /// @return Its ID and result, or nothing if the timeout passes first.
+  std::optional<std::pair<k_int, k_value>> awaitAny(
+      const std::vector<k_int>& ids, std::optional<k_int> timeoutMs) {
+    k_int finished = -1;
+    auto lock = waitFor(ids, timeoutMs, [this, &ids, &finished]() {
+      for (const auto& id : ids) {
+        const auto& slot = slots[id];
+        if (slot.done && (finished == -1 ||
+                          slot.finishOrder < slots[finished].finishOrder)) {
+          finished = id;
+        }
+      }
+      return finished != -1;
+    });
+
+    if (!lock) {
+      return std::nullopt;
+    }
+
+    return std::make_pair(finished, release(finished));
+  }
+
+  /// @brief Blocks until every task started so far has finished.
+  void waitForAll() {
+    std::unique_lock<std::mutex> lock(mutex);
+    completed.wait(lock, [this]() { return activeTasks.load() == 0; });
+  }
 
   bool isTaskCompleted(k_int id) {
-    return tasks.at(id).wait_for(std::chrono::seconds(0)) ==
-           std::future_status::ready;
+    std::lock_guard<std::mutex> lock(mutex);
+    return getSlot(id).done;
   }
 
-  bool hasActiveTasks() {
-    for (auto& activeTask : tasks) {
-      if (activeTask.second.wait_for(std::chrono::seconds(0)) !=
-          std::future_status::ready) {
-        return true;
+  bool hasActiveTasks() { return activeTasks.load() > 0; }
+
+  size_t getWorkerCount() { return scheduler.getWorkerCount(); }
+
+  /// @brief Blocks until `ready` holds, the same way tasks are awaited. For
+  /// state kept outside the manager: whoever changes what `ready` reads must
+  /// call `notify` afterwards.
+  /// @return False if the timeout passed first.
+  template <typename Predicate>
+  bool waitUntil(Predicate ready, std::optional<k_int> timeoutMs) {
+    std::unique_lock<std::mutex> lock(mutex);
+    return wait(lock, timeoutMs, ready);
+  }
+
+  /// @brief Wakes the threads in `waitUntil`. Cheap when nobody waits.
+  void notify() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters.load(std::memory_order_relaxed) == 0) {
+      return;
+    }
+
+    std::vector<std::shared_ptr<TaskScheduler::Waker>> woken;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      woken.swap(parked);
+    }
+    wakeAll(woken);
+  }
+
+ private:
+  /// @brief Blocks until `ready` holds for the tasks in `ids`.
+  /// @return The held lock, or nothing if the timeout passed first.
+  template <typename Predicate>
+  std::optional<std::unique_lock<std::mutex>> waitFor(
+      const std::vector<k_int>& ids, std::optional<k_int> timeoutMs,
+      Predicate ready) {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (const auto& id : ids) {
+      getSlot(id);
+    }
+
+    if (!wait(lock, timeoutMs, ready)) {
+      return std::nullopt;
+    }
+    return lock;
+  }
+
+  /// @brief Waits until `ready` holds. A task on a fiber parks and suspends,
+  /// freeing its worker. Any other thread waits on `completed` and counts as
+  /// blocked, so the pool starts a spare thread rather than let queued
+  /// tasks, which may be the ones it waits for, starve. Cancelling the
+  /// waiting task throws `TaskCancelled`.
+  /// @return False if the timeout passed first.
+  template <typename Predicate>
+  bool wait(std::unique_lock<std::mutex>& lock,
+            std::optional<k_int> timeoutMs, Predicate& ready) {
+    if (ready()) {
+      return true;
+    }
+
+    CancellationToken::check();
+    auto token = CancellationToken::current();
+
+    ++waiters;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    struct Leave {
+      std::atomic<size_t>& waiters;
+      ~Leave() { --waiters; }
+    } leave{waiters};
+
+    std::optional<TaskScheduler::Clock::time_point> deadline;
+    if (timeoutMs) {
+      deadline = TaskScheduler::Clock::now() +
+                 std::chrono::milliseconds(*timeoutMs);
+    }
+
+    if (TaskScheduler::canSuspend()) {
+      while (!ready()) {
+        CancellationToken::check();
+        if (deadline && TaskScheduler::Clock::now() >= *deadline) {
+          return false;
+        }
+
+        auto waker = TaskScheduler::prepareSuspend();
+        parked.push_back(waker);
+        TimerWheel::Id timeout = 0;
+        if (deadline) {
+          timeout = scheduler.wakeAt(*deadline, waker);
+        }
+
+        lock.unlock();
+        TaskScheduler::suspend();
+        if (timeout) {
+          scheduler.cancelTimer(timeout);  // Woken sooner, or a no-op.
+        }
+        lock.lock();
       }
+      return true;
     }
 
+    // `ready` may take what it waits for, so it is only called once a wake.
+    auto isReady = false;
+    auto woken = [&]() {
+      isReady = ready();
+      return isReady || (token && token->isPending());
+    };
+
+    TaskScheduler::Blocking blocking;
+    if (deadline) {
+      completed.wait_until(lock, *deadline, woken);
+    } else {
+      completed.wait(lock, woken);
+    }
+
+    if (isReady) {
+      return true;
+    }
+    CancellationToken::check();
     return false;
   }
+
+  /// @brief Wakes every waiter, blocked or parked, to check its condition.
+  void wakeAll(std::vector<std::shared_ptr<TaskScheduler::Waker>>& woken) {
+    completed.notify_all();
+    for (const auto& waker : woken) {
+      waker->wake();
+    }
+  }
+
+  /// @brief Sets the timer for the next run of a schedule. Called with
+  /// `schedulesMutex` held.
+  void arm(k_int id, Schedule& entry) {
+    entry.timer =
+        scheduler.addTimer(entry.deadline, [this, id]() { fire(id); });
+  }
+
+  /// @brief Posts the job of a schedule that came due, on the timer thread.
+  void fire(k_int id) {
+    std::shared_ptr<Schedule> entry;
+    {
+      std::lock_guard<std::mutex> lock(schedulesMutex);
+      auto it = schedules.find(id);
+      if (it == schedules.end()) {
+        return;
+      }
+
+      entry = it->second;
+      if (entry->period > TaskScheduler::Clock::duration::zero()) {
+        // Counted from the last deadline, so runs don't drift. Runs missed
+        // while the process was held up are dropped.
+        auto now = TaskScheduler::Clock::now();
+        entry->deadline += entry->period;
+        if (entry->deadline <= now) {
+          entry->deadline +=
+              ((now - entry->deadline) / entry->period + 1) * entry->period;
+        }
+        arm(id, *entry);
+      } else {
+        schedules.erase(it);
+      }
+    }
+
+    if (entry->running.exchange(true)) {
+      return;  // Still going.
+    }
+
+    post([entry]() {
+      entry->job();
+      entry->running = false;
+    });
+  }
+
+  Slot& getSlot(k_int id) {
+    if (id < 0 || id >= static_cast<k_int>(slots.size()) ||
+        !slots[id].inUse) {
+      throw std::out_of_range("Unknown task " + std::to_string(id) + ".");
+    }
+    return slots[id];
+  }
+
+  k_value release(k_int id) {
+    auto& slot = getSlot(id);
+    auto result = std::move(slot.result);
+    auto error = slot.error;
+    slot = Slot();
+    freeIds.push_back(id);
+
+    if (error) {
+      std::rethrow_exception(error);
+    }
+    return result;
+  }
 };
 
 #endif
@@ -0,0 +1,254 @@
+#ifndef KIWI_CONCURRENCY_TIMER_H
+#define KIWI_CONCURRENCY_TIMER_H
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Runs callbacks at their deadlines on a thread of its own, started on first
+// use. Callbacks should only hand work elsewhere, since each one holds up the
+// ones due after it.
+//
+// Timers are kept in a hierarchical wheel with a millisecond tick. Each level
+// has 64 slots and each slot of a level spans a full turn of the level below.
+// A timer goes in the lowest level whose turn reaches its deadline, and moves
+// down a level each time the clock reaches its slot, so adding or cancelling
+// a timer costs the same however many are pending. Deadlines too far out for
+// the top level wait in its last slot and are placed again from there.
+class TimerWheel {
+ public:
+  using Clock = std::chrono::steady_clock;
+  using Callback = std::function<void()>;
+  using Id = uint64_t;
+
+  TimerWheel() : origin(Clock::now()) {}
+  ~TimerWheel() { stop(); }
+
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+
+  /// @brief Runs `callback` at `deadline`, never before.
+  /// @return An ID to cancel the timer with, or 0 if the wheel has stopped.
+  Id add(Clock::time_point deadline, Callback callback) {
+    bool sooner;
+    Id id;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (stopping) {
+        return 0;
+      }
+
+      if (!thread.joinable()) {
+        thread = std::thread([this]() { run(); });
+      }
+
+      id = nextId++;
+      auto tick = std::max(toTick(deadline), current + 1);
+      callbacks.emplace(id, std::move(callback));
+      place({tick, id});
+      sooner = tick < wakeTick;
+    }
+
+    if (sooner) {
+      changed.notify_one();
+    }
+    return id;
+  }
+
+  /// @brief Drops a timer that has not run yet. Its slot entry is skipped
+  /// once the clock reaches it.
+  /// @return True if the timer was pending.
+  bool cancel(Id id) {
+    Callback dropped;  // Released outside the lock.
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = callbacks.find(id);
+    if (it == callbacks.end()) {
+      return false;
+    }
+
+    dropped = std::move(it->second);
+    callbacks.erase(it);
+    return true;
+  }
+
+  /// @brief Drops the callbacks not yet due and joins the thread.
+  void stop() {
+    std::unordered_map<Id, Callback> dropped;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+      dropped.swap(callbacks);
+    }
+    changed.notify_one();
+
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+
+ private:
+  static constexpr unsigned SlotBits = 6;
+  static constexpr uint64_t SlotCount = uint64_t(1) << SlotBits;
+  static constexpr uint64_t SlotMask = SlotCount - 1;
+  static constexpr unsigned LevelCount = 4;  // About 4.6 hours of ticks.
+  static constexpr uint64_t Never = std::numeric_limits<uint64_t>::max();
+
+  struct Entry {
+    uint64_t tick;
+    Id id;
+  };
+
+  const Clock::time_point origin;
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::vector<Entry> slots[LevelCount][SlotCount];
+  std::unordered_map<Id, Callback> callbacks;  // Pending, by ID.
+  size_t entries = 0;  // In the slots, cancelled or not.
+  uint64_t current = 0;  // The last tick run.
+  uint64_t wakeTick = Never;  // The tick the thread sleeps until.
+  Id nextId = 1;
+  bool stopping = false;
+  std::thread thread;
+
+  static unsigned shift(unsigned level) { return level * SlotBits; }
+
+  /// @brief The tick a deadline falls on, rounded up.
+  uint64_t toTick(Clock::time_point deadline) const {
+    if (deadline <= origin) {
+      return 0;
+    }
+
+    auto elapsed = deadline - origin;
+    auto ticks = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed);
+    if (ticks < elapsed) {
+      ticks += std::chrono::milliseconds(1);
+    }
+    return static_cast<uint64_t>(ticks.count());
+  }
+
+  /// @brief The last tick that has begun.
+  uint64_t elapsedTicks() const {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() -
+                                                              origin)
+            .count());
+  }
+
+  /// @brief Puts an entry in the slot that holds it until its tick comes or
+  /// it has to move down a level. The tick must be after `current`.
+  void place(const Entry& entry) {
+    auto delta = entry.tick - current;
+    for (unsigned level = 0; level < LevelCount; ++level) {
+      if (delta < (SlotCount << shift(level))) {
+        slots[level][(entry.tick >> shift(level)) & SlotMask].push_back(entry);
+        ++entries;
+        return;
+      }
+    }
+
+    // Beyond the top level: park in its furthest slot and place again later.
+    auto furthest = current + (SlotCount << shift(LevelCount - 1)) - 1;
+    slots[LevelCount - 1][(furthest >> shift(LevelCount - 1)) & SlotMask]
+        .push_back(entry);
+    ++entries;
+  }
+
+  /// @brief The next tick after `current` at which a slot has to be run or
+  /// moved down a level.
+  uint64_t nextTick() const {
+    auto next = Never;
+    for (unsigned level = 0; level < LevelCount; ++level) {
+      // A level's slot is reached when the ticks below it roll over.
+      auto base = current >> shift(level);
+      for (uint64_t step = 1; step <= SlotCount; ++step) {
+        auto slot = (base + step) & SlotMask;
+        if (!slots[level][slot].empty()) {
+          next = std::min(next, (base + step) << shift(level));
+          break;
+        }
+      }
+    }
+    return next;
+  }
+
+  /// @brief Advances the clock to `tick` and collects the callbacks due.
+  void advance(uint64_t tick, std::vector<Callback>& due) {
+    current = tick;
+
+    // Move the slots reached on each upper level down, top first.
+    for (unsigned level = LevelCount - 1; level > 0; --level) {
+      if ((tick & ((uint64_t(1) << shift(level)) - 1)) != 0) {
+        continue;
+      }
+
+      auto& slot = slots[level][(tick >> shift(level)) & SlotMask];
+      std::vector<Entry> moved;
+      moved.swap(slot);
+      entries -= moved.size();
+      for (const auto& entry : moved) {
+        if (entry.tick > tick) {
+          place(entry);
+        } else {
+          slots[0][tick & SlotMask].push_back(entry);
+          ++entries;
+        }
+      }
+    }
+
+    auto& slot = slots[0][tick & SlotMask];
+    std::vector<Entry> reached;
+    reached.swap(slot);
+    entries -= reached.size();
+    for (const auto& entry : reached) {
+      auto it = callbacks.find(entry.id);
+      if (it != callbacks.end()) {
+        due.push_back(std::move(it->second));
+        callbacks.erase(it);
+      }
+    }
+  }
+
+  void run() {
+    std::vector<Callback> due;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+      auto now = elapsedTicks();
+      if (entries == 0) {
+        current = std::max(current, now);
+        wakeTick = Never;
+        changed.wait(lock);
+        continue;
+      }
+
+      // Nothing happens between ticks without slots, so skip them.
+      auto next = nextTick();
+      if (now < next) {
+        wakeTick = next;
+        changed.wait_until(lock, origin + std::chrono::milliseconds(next));
+        continue;
+      }
+
+      wakeTick = Never;
+      advance(next, due);
+      if (due.empty()) {
+        continue;
+      }
+
+      lock.unlock();
+      for (auto& callback : due) {
+        callback();
+      }
+      due.clear();
+      lock.lock();
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef KIWI_CONTEXT_H
+#define KIWI_CONTEXT_H
+
+#include <memory>
+#include <mutex>
+#include <stack>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "concurrency/fiber.h"
+#include "parsing/tokens.h"
+#include "stackframe.h"
+
+// The stacks of one thread of execution. The main script runs in the shared
+// context and each async task runs in a context of its own, so tasks can
+// interpret code in parallel without touching each other's frames.
+class ExecutionContext {
+ public:
+  CallStack callStack;
+  std::stack<k_stream> streamStack;
+  std::stack<std::string> packageStack;
+
+  /// @brief The context of the calling thread.
+  static ExecutionContext& current() {
+    auto active = static_cast<ExecutionContext*>(Fiber::local());
+    return active ? *active : shared();
+  }
+
+  /// @brief The context of the main script, used by any thread that has not
+  /// entered one of its own.
+  static ExecutionContext& shared() {
+    static ExecutionContext instance;
+    return instance;
+  }
+
+  /// @brief Whether this is the context of the main script.
+  bool isShared() const { return this == &shared(); }
+
+  /// @brief Creates a context for a task started from the current one. The
+  /// task sees a copy of the frames on the call stack, so it can read the
+  /// variables in scope when it started without racing their owner.
+  static std::shared_ptr<ExecutionContext> fork() {
+    auto context = std::make_shared<ExecutionContext>();
+    std::unordered_map<const CallStackFrame*, std::shared_ptr<CallStackFrame>>
+        copies;
+
+    auto& frames = current().callStack;
+    for (auto it = frames.rbegin(); it != frames.rend(); ++it) {
+      auto copy = (*it)->fork();
+      auto parent = copies.find(copy->parent.get());
+      if (parent != copies.end()) {
+        copy->parent = parent->second;
+      }
+      copies[it->get()] = copy;
+      context->callStack.push(std::move(copy));
+    }
+
+    return context;
+  }
+
+  // Makes a context current on this thread, or fiber, until the scope exits.
+  class Scope {
+   public:
+    explicit Scope(ExecutionContext& context) : previous(Fiber::local()) {
+      Fiber::local() = &context;
+    }
+    ~Scope() { Fiber::local() = previous; }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    void* previous;
+  };
+
+  // Empty contexts kept for short-lived work that starts from nothing, such
+  // as a web request, so each piece of work gets stacks of its own without
+  // allocating them every time.
+  class Pool {
+   public:
+    // Takes a context from the pool until the scope exits, then returns it
+    // emptied.
+    class Lease {
+     public:
+      explicit Lease(Pool& pool) : pool(pool), context(pool.acquire()) {}
+      ~Lease() { pool.release(std::move(context)); }
+
+      Lease(const Lease&) = delete;
+      Lease& operator=(const Lease&) = delete;
+
+      ExecutionContext& get() { return *context; }
+
+     private:
+      Pool& pool;
+      std::unique_ptr<ExecutionContext> context;
+    };
+
+   private:
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ExecutionContext>> idle;
+
+    std::unique_ptr<ExecutionContext> acquire() {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (idle.empty()) {
+        return std::make_unique<ExecutionContext>();
+      }
+
+      auto context = std::move(idle.back());
+      idle.pop_back();
+      return context;
+    }
+
+    void release(std::unique_ptr<ExecutionContext> context) {
+      context->callStack = CallStack();
+      context->streamStack = {};
+      context->packageStack = {};
+
+      std::lock_guard<std::mutex> lock(mutex);
+      idle.push_back(std::move(context));
+    }
+  };
+};
+
+#endif
@@ -18,31 +18,39 @@ extern const std::string kiwi_min_extension = ".min.🥝";
 extern const std::string kiwi_extension = ".🥝";
 #endif
 
+#include <atomic>
 #include <unordered_map>
 #include <stack>
 #include <memory>
 #include <string>
 #include <mutex>
+#include <shared_mutex>
 #include "logging/logger.h"
+#include "concurrency/channel.h"
+#include "concurrency/concurrent.h"
 #include "concurrency/task.h"
 #include "objects/method.h"
 #include "objects/package.h"
 #include "objects/class.h"
+#include "context.h"
 #include "stackframe.h"
 #include "parsing/tokens.h"
 #include "web/httplib.h"
 
 extern Logger logger;
+extern ChannelRegistry channels;
+extern AtomicRegistry atomics;
+extern ConcurrentMapRegistry concurrentMaps;
 extern TaskManager task;
 extern std::unordered_map<std::string, Method> methods;
 extern std::unordered_map<std::string, Package> packages;
 extern std::unordered_map<std::string, Class> classes;
+extern std::atomic<uint64_t> classGeneration;
+extern std::shared_mutex definitionsMutex;
 extern std::unordered_map<std::string, std::string> kiwiArgs;
-extern std::stack<std::shared_ptr<CallStackFrame>> callStack;
-extern std::stack<k_stream> streamStack;
-extern std::stack<std::string> packageStack;
 extern httplib::Server kiwiWebServer;
 extern std::unordered_map<int, Method> kiwiWebServerHooks;
+extern ExecutionContext::Pool kiwiWebServerContexts;
 extern std::string kiwiWebServerHost;
 extern k_int kiwiWebServerPort;
 
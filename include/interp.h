@@ -10,6 +10,7 @@
 #include "objects/method.h"
 #include "objects/package.h"
 #include "objects/sliceindex.h"
+#include "parsing/ast.h"
 #include "parsing/builtins.h"
 #include "parsing/lexer.h"
 #include "parsing/tokens.h"
@@ -21,7 +22,10 @@
 #include "typing/serializer.h"
 #include "typing/value.h"
 #include "util/file.h"
+#include "util/file_reader.h"
 #include "util/string.h"
+#include "vm/bytecode.h"
+#include "vm/vm.h"
 #include "globals.h"
 #include "builtin.h"
 #include "interp_helper.h"
@@ -36,6 +40,14 @@ class Interpreter {
     kiwiArgs = args;
   }
 
+  /// @brief Evaluate compiled expressions on the bytecode VM.
+  /// @param verify Also evaluate each expression by walking its tokens and
+  /// raise a `VirtualMachineError` if the two engines disagree.
+  void enableVirtualMachine(bool verify = false) {
+    vmEnabled = true;
+    vmVerify = verify;
+  }
+
   int interpretKiwi(const k_string& kiwiCode) {
     Lexer lexer("", kiwiCode);
     return interpret(lexer);
@@ -115,14 +127,26 @@ class Interpreter {
   void preserveMainStackFrame() { preservingMainStackFrame = true; }
 
  private:
+  bool vmEnabled = false;
+  bool vmVerify = false;
+
   bool preservingMainStackFrame = false;
 
+  // The stacks of the context running on this thread.
+  CallStack& callStack() { return ExecutionContext::current().callStack; }
+  std::stack<k_stream>& streamStack() {
+    return ExecutionContext::current().streamStack;
+  }
+  std::stack<k_string>& packageStack() {
+    return ExecutionContext::current().packageStack;
+  }
+
   void dumpState() {
     std::cout << kiwi_arg << " v" << kiwi_version << " state dump" << std::endl;
 
-    std::cout << "streams: " << streamStack.size() << std::endl;
+    std::cout << "streams: " << streamStack().size() << std::endl;
     int counter = 0;
-    auto tempStreamStack(streamStack);
+    auto tempStreamStack(streamStack());
     while (!tempStreamStack.empty()) {
       std::cout << counter++
                 << " stream size: " << tempStreamStack.top()->tokens.size()
@@ -130,25 +154,22 @@ class Interpreter {
       tempStreamStack.pop();
     }
 
-    std::cout << "frames: " << callStack.size() << std::endl;
+    std::cout << "frames: " << callStack().size() << std::endl;
     counter = 0;
-    auto tempCallStack(callStack);
-    while (!tempCallStack.empty()) {
-      const auto& frame = tempCallStack.top();
+    for (const auto& frame : callStack()) {
       const auto& frameVariables = frame->variables;
       const auto& frameLambdas = frame->lambdas;
       std::cout << counter << " frame variables: " << frameVariables.size()
                 << std::endl;
-      for (const auto& var : frameVariables) {
-        std::cout << "  name: " << var.first << std::endl;
-      }
+      frameVariables.forEach([](const k_string& name, const k_value&) {
+        std::cout << "  name: " << name << std::endl;
+      });
       std::cout << counter++ << " frame lambdas: " << frameLambdas.size()
                 << std::endl;
       for (const auto& lambda : frameLambdas) {
         std::cout << "  name: " << lambda.first
                   << ", size: " << lambda.second.getCode().size() << std::endl;
       }
-      tempCallStack.pop();
     }
 
     std::cout << "packages: " << packages.size() << std::endl;
@@ -182,14 +203,17 @@ class Interpreter {
 
   k_int interpretAsyncMethodInvocation(
       std::shared_ptr<CallStackFrame> codeFrame, const Method& method) {
-    auto taskFunc = [this, codeFrame, method]() -> k_value {
-      callStack.push(codeFrame);
-      streamStack.push(std::make_shared<TokenStream>(method.getCode()));
+    auto context = ExecutionContext::fork();
+    auto taskFunc = [this, context, codeFrame, method]() -> k_value {
+      ExecutionContext::Scope scope(*context);
+      codeFrame->clearFlag(FrameFlags::InTry);  // The caller's `try` ends here.
+      callStack().push(codeFrame);
+      streamStack().push(compiledStream(method));
 
       interpretStackFrame();
 
-      if (!callStack.empty()) {
-        return callStack.top()->returnValue;
+      if (!callStack().empty()) {
+        return callStack().top()->returnValue;
       }
 
       return {};
@@ -207,16 +231,538 @@ class Interpreter {
       throw SyntaxError(term, "Expected identifier near `await`.");
     }
 
+    // Either an async call (`await work()`) or a task started earlier.
     const auto& identifier = term.getText();
     const auto& taskId =
-        interpretMethodInvocation(stream, frame, identifier, true);
+        hasMethod(frame, identifier)
+            ? interpretMethodInvocation(stream, frame, identifier, true)
+            : parseExpression(stream, frame);
     if (!std::holds_alternative<k_int>(taskId)) {
       throw ConversionError(term, "Expected a task.");
     }
 
+    // `await task timeout ms` gives up after `ms`. The task keeps running
+    // and can be awaited again.
+    if (stream->current().getType() == KTokenType::IDENTIFIER &&
+        stream->current().getText() == "timeout") {
+      stream->next();  // Skip "timeout"
+
+      auto timeoutMs = get_integer(term, parseExpression(stream, frame));
+      if (timeoutMs < 0) {
+        throw InvalidOperationError(term, "Expected a non-negative timeout.");
+      }
+
+      std::vector<k_int> ids = {std::get<k_int>(taskId)};
+      auto results = task.awaitAll(ids, timeoutMs);
+      if (!results) {
+        throw TaskTimeoutError(term, "Timed out awaiting a task.");
+      }
+      return std::move(results->front());
+    }
+
     return task.getTaskResult(std::get<k_int>(taskId));
   }
 
+  k_value interpretTaskBuiltin(k_stream stream, const KName& builtin,
+                               std::vector<k_value>& args) {
+    const auto& term = stream->current();
+    if (builtin == KName::Builtin_Task_Cancel) {
+      if (args.size() != 1 || !std::holds_alternative<k_int>(args.at(0))) {
+        throw BuiltinUnexpectedArgumentError(term, TaskBuiltins.Cancel);
+      }
+      return task.cancel(std::get<k_int>(args.at(0)));
+    }
+
+    if (args.size() != 1 && args.size() != 2) {
+      throw BuiltinUnexpectedArgumentError(
+          term, builtin == KName::Builtin_Task_AwaitAll
+                    ? TaskBuiltins.AwaitAll
+                    : TaskBuiltins.AwaitAny);
+    }
+
+    auto ids = getTaskIds(term, args.at(0));
+    std::optional<k_int> timeoutMs;
+    if (args.size() == 2) {
+      timeoutMs = get_integer(term, args.at(1));
+      if (*timeoutMs < 0) {
+        throw InvalidOperationError(term, "Expected a non-negative timeout.");
+      }
+    }
+
+    if (builtin == KName::Builtin_Task_AwaitAll) {
+      auto results = task.awaitAll(ids, timeoutMs);
+      if (!results) {
+        throw TaskTimeoutError(term, "Timed out awaiting all tasks.");
+      }
+
+      auto list = std::make_shared<List>();
+      list->elements() = std::move(*results);
+      return list;
+    }
+
+    if (ids.empty()) {
+      throw EmptyListError(term);
+    }
+
+    auto first = task.awaitAny(ids, timeoutMs);
+    if (!first) {
+      throw TaskTimeoutError(term, "Timed out awaiting any task.");
+    }
+
+    auto hash = std::make_shared<Hash>();
+    hash->add("id", first->first);
+    hash->add("result", first->second);
+    return hash;
+  }
+
+  k_value interpretChannelBuiltin(k_stream stream, const KName& builtin,
+                                  std::vector<k_value>& args) {
+    const auto& term = stream->current();
+
+    switch (builtin) {
+      case KName::Builtin_Channel_Create:
+        return interpretChannelCreate(term, args);
+
+      case KName::Builtin_Channel_Send:
+      case KName::Builtin_Channel_TrySend:
+        return interpretChannelSend(term, builtin, args);
+
+      case KName::Builtin_Channel_Recv:
+      case KName::Builtin_Channel_TryRecv:
+        return interpretChannelRecv(term, builtin, args);
+
+      case KName::Builtin_Channel_Select:
+        return interpretChannelSelect(term, args);
+
+      case KName::Builtin_Channel_Close:
+        if (args.size() != 1) {
+          throw BuiltinUnexpectedArgumentError(term, ChannelBuiltins.Close);
+        }
+        getChannel(term, args.at(0))->close();
+        task.notify();  // Blocked receivers see the end of the channel.
+        return static_cast<k_int>(0);
+
+      case KName::Builtin_Channel_IsClosed:
+        if (args.size() != 1) {
+          throw BuiltinUnexpectedArgumentError(term, ChannelBuiltins.IsClosed);
+        }
+        return getChannel(term, args.at(0))->isClosed();
+
+      default:
+        break;
+    }
+
+    throw UnknownBuiltinError(term, term.getText());
+  }
+
+  k_value interpretChannelCreate(const Token& term,
+                                 std::vector<k_value>& args) {
+    if (args.size() != 1) {
+      throw BuiltinUnexpectedArgumentError(term, ChannelBuiltins.Create);
+    }
+
+    auto capacity = get_integer(term, args.at(0));
+    if (capacity < 1) {
+      throw InvalidOperationError(term, "Expected a positive capacity.");
+    }
+
+    return channels.create(static_cast<size_t>(capacity));
+  }
+
+  k_value interpretChannelSend(const Token& term, const KName& builtin,
+                               std::vector<k_value>& args) {
+    auto blocking = builtin == KName::Builtin_Channel_Send;
+    if (args.size() != 2) {
+      throw BuiltinUnexpectedArgumentError(
+          term, blocking ? ChannelBuiltins.Send : ChannelBuiltins.TrySend);
+    }
+
+    auto channel = getChannel(term, args.at(0));
+    auto value = clone_value(args.at(1));  // The receiver gets its own copy.
+
+    auto sent = channel->trySend(value);
+    if (!sent && blocking && !channel->isClosed()) {
+      task.waitUntil(
+          [&]() {
+            sent = channel->trySend(value);
+            return sent || channel->isClosed();
+          },
+          std::nullopt);
+    }
+
+    if (!sent && channel->isClosed()) {
+      throw ChannelError(term, "Cannot send on a closed channel.");
+    }
+
+    if (sent) {
+      task.notify();
+    }
+    return sent;
+  }
+
+  k_value interpretChannelRecv(const Token& term, const KName& builtin,
+                               std::vector<k_value>& args) {
+    auto blocking = builtin == KName::Builtin_Channel_Recv;
+    if (args.size() != 1) {
+      throw BuiltinUnexpectedArgumentError(
+          term, blocking ? ChannelBuiltins.Recv : ChannelBuiltins.TryRecv);
+    }
+
+    auto channel = getChannel(term, args.at(0));
+    k_value value;
+    auto drained = false;
+
+    auto received = channel->tryRecvOrDrained(value, drained) && !drained;
+    if (!received && blocking && !drained) {
+      task.waitUntil(
+          [&]() { return channel->tryRecvOrDrained(value, drained); },
+          std::nullopt);
+      received = !drained;
+    }
+
+    if (received) {
+      task.notify();  // Room for a blocked sender.
+    }
+
+    if (blocking) {
+      if (!received) {
+        throw ChannelError(term, "The channel is closed.");
+      }
+      return value;
+    }
+
+    auto result = std::make_shared<Hash>();
+    result->add("ok", received);
+    if (received) {
+      result->add("value", value);
+    }
+    return result;
+  }
+
+  /// @brief Receives from whichever channel has a value first. Channels are
+  /// polled from a rotating start, so a busy channel can't starve the rest.
+  k_value interpretChannelSelect(const Token& term,
+                                 std::vector<k_value>& args) {
+    if (args.size() != 1 && args.size() != 2) {
+      throw BuiltinUnexpectedArgumentError(term, ChannelBuiltins.Select);
+    }
+
+    if (!std::holds_alternative<k_list>(args.at(0))) {
+      throw ConversionError(term, "Expected a list of channels.");
+    }
+
+    std::vector<std::pair<k_int, std::shared_ptr<Channel>>> selected;
+    for (const auto& id : std::get<k_list>(args.at(0))->view()) {
+      selected.emplace_back(get_integer(term, id), getChannel(term, id));
+    }
+
+    if (selected.empty()) {
+      throw EmptyListError(term);
+    }
+
+    std::optional<k_int> timeoutMs;
+    if (args.size() == 2) {
+      timeoutMs = get_integer(term, args.at(1));
+      if (*timeoutMs < 0) {
+        throw InvalidOperationError(term, "Expected a non-negative timeout.");
+      }
+    }
+
+    static std::atomic<size_t> rotation{0};
+    auto start = rotation++;
+    k_int from = -1;
+    k_value value;
+    auto allDrained = false;
+
+    auto poll = [&]() {
+      size_t drainedCount = 0;
+      for (size_t i = 0; i < selected.size(); ++i) {
+        const auto& [id, channel] = selected[(start + i) % selected.size()];
+        auto drained = false;
+        if (channel->tryRecvOrDrained(value, drained) && !drained) {
+          from = id;
+          return true;
+        }
+        drainedCount += drained ? 1 : 0;
+      }
+
+      allDrained = drainedCount == selected.size();
+      return allDrained;
+    };
+
+    if (!poll() && !task.waitUntil(poll, timeoutMs)) {
+      return std::make_shared<Hash>();  // Timed out.
+    }
+
+    if (allDrained) {
+      throw ChannelError(term, "All channels are closed.");
+    }
+
+    task.notify();
+
+    auto result = std::make_shared<Hash>();
+    result->add("channel", from);
+    result->add("value", value);
+    return result;
+  }
+
+  std::shared_ptr<Channel> getChannel(const Token& term, const k_value& id) {
+    auto channel = channels.get(get_integer(term, id));
+    if (!channel) {
+      throw ChannelError(term, "Unknown channel.");
+    }
+    return channel;
+  }
+
+  k_value interpretConcurrentBuiltin(k_stream stream, const KName& builtin,
+                                     std::vector<k_value>& args) {
+    const auto& term = stream->current();
+
+    switch (builtin) {
+      case KName::Builtin_Concurrent_AtomicCreate:
+        if (args.size() != 1) {
+          throw BuiltinUnexpectedArgumentError(term,
+                                               ConcurrentBuiltins.AtomicCreate);
+        }
+        return atomics.create(get_integer(term, args.at(0)));
+
+      case KName::Builtin_Concurrent_AtomicGet:
+        if (args.size() != 1) {
+          throw BuiltinUnexpectedArgumentError(term,
+                                               ConcurrentBuiltins.AtomicGet);
+        }
+        return getAtomic(term, args.at(0))->load();
+
+      case KName::Builtin_Concurrent_AtomicSet:
+        if (args.size() != 2) {
+          throw BuiltinUnexpectedArgumentError(term,
+                                               ConcurrentBuiltins.AtomicSet);
+        }
+        return getAtomic(term, args.at(0))
+            ->exchange(get_integer(term, args.at(1)));
+
+      case KName::Builtin_Concurrent_AtomicAdd: {
+        if (args.size() != 2) {
+          throw BuiltinUnexpectedArgumentError(term,
+                                               ConcurrentBuiltins.AtomicAdd);
+        }
+        auto delta = get_integer(term, args.at(1));
+        return getAtomic(term, args.at(0))->fetch_add(delta) + delta;
+      }
+
+      case KName::Builtin_Concurrent_AtomicCas: {
+        if (args.size() != 3) {
+          throw BuiltinUnexpectedArgumentError(term,
+                                               ConcurrentBuiltins.AtomicCas);
+        }
+        auto expected = get_integer(term, args.at(1));
+        return getAtomic(term, args.at(0))
+            ->compare_exchange_strong(expected, get_integer(term, args.at(2)));
+      }
+
+      case KName::Builtin_Concurrent_MapCreate:
+        if (!args.empty()) {
+          throw BuiltinUnexpectedArgumentError(term,
+                                               ConcurrentBuiltins.MapCreate);
+        }
+        return concurrentMaps.create();
+
+      case KName::Builtin_Concurrent_MapGet: {
+        if (args.size() != 2 && args.size() != 3) {
+          throw BuiltinUnexpectedArgumentError(term, ConcurrentBuiltins.MapGet);
+        }
+        auto key = get_string(term, args.at(1));
+        k_value value;
+        if (getConcurrentMap(term, args.at(0))->get(key, value)) {
+          return value;
+        }
+        if (args.size() == 3) {
+          return args.at(2);
+        }
+        throw HashKeyError(term, key);
+      }
+
+      case KName::Builtin_Concurrent_MapSet:
+        if (args.size() != 3) {
+          throw BuiltinUnexpectedArgumentError(term, ConcurrentBuiltins.MapSet);
+        }
+        getConcurrentMap(term, args.at(0))
+            ->set(get_string(term, args.at(1)), args.at(2));
+        return args.at(2);
+
+      case KName::Builtin_Concurrent_MapAdd: {
+        if (args.size() != 3) {
+          throw BuiltinUnexpectedArgumentError(term, ConcurrentBuiltins.MapAdd);
+        }
+        auto delta = clone_value(args.at(2));
+        return getConcurrentMap(term, args.at(0))
+            ->update(get_string(term, args.at(1)),
+                     [&](k_value& value, bool exists) {
+                       value = exists
+                                   ? MathImpl.do_addition(term, value, delta)
+                                   : delta;
+                       return true;
+                     });
+      }
+
+      case KName::Builtin_Concurrent_MapRemove:
+        if (args.size() != 2) {
+          throw BuiltinUnexpectedArgumentError(term,
+                                               ConcurrentBuiltins.MapRemove);
+        }
+        return getConcurrentMap(term, args.at(0))
+            ->remove(get_string(term, args.at(1)));
+
+      case KName::Builtin_Concurrent_MapHas:
+        if (args.size() != 2) {
+          throw BuiltinUnexpectedArgumentError(term, ConcurrentBuiltins.MapHas);
+        }
+        return getConcurrentMap(term, args.at(0))
+            ->has(get_string(term, args.at(1)));
+
+      case KName::Builtin_Concurrent_MapSize:
+        if (args.size() != 1) {
+          throw BuiltinUnexpectedArgumentError(term,
+                                               ConcurrentBuiltins.MapSize);
+        }
+        return static_cast<k_int>(getConcurrentMap(term, args.at(0))->size());
+
+      case KName::Builtin_Concurrent_MapClear:
+        if (args.size() != 1) {
+          throw BuiltinUnexpectedArgumentError(term,
+                                               ConcurrentBuiltins.MapClear);
+        }
+        getConcurrentMap(term, args.at(0))->clear();
+        return static_cast<k_int>(0);
+
+      case KName::Builtin_Concurrent_MapSnapshot: {
+        if (args.size() != 1) {
+          throw BuiltinUnexpectedArgumentError(term,
+                                               ConcurrentBuiltins.MapSnapshot);
+        }
+        auto hash = std::make_shared<Hash>();
+        for (auto& [key, value] :
+             getConcurrentMap(term, args.at(0))->snapshot()) {
+          hash->add(key, std::move(value));
+        }
+        return hash;
+      }
+
+      default:
+        break;
+    }
+
+    throw UnknownBuiltinError(term, "");
+  }
+
+  std::shared_ptr<std::atomic<k_int>> getAtomic(const Token& term,
+                                                const k_value& id) {
+    auto atomic = atomics.get(get_integer(term, id));
+    if (!atomic) {
+      throw InvalidOperationError(term, "Unknown atomic.");
+    }
+    return atomic;
+  }
+
+  std::shared_ptr<ConcurrentMap> getConcurrentMap(const Token& term,
+                                                  const k_value& id) {
+    auto map = concurrentMaps.get(get_integer(term, id));
+    if (!map) {
+      throw InvalidOperationError(term, "Unknown concurrent map.");
+    }
+    return map;
+  }
+
+  k_value interpretTimerBuiltin(k_stream stream,
+                                std::shared_ptr<CallStackFrame> frame,
+                                const KName& builtin,
+                                std::vector<k_value>& args) {
+    const auto& term = stream->current();
+
+    if (builtin == KName::Builtin_Timer_Cancel) {
+      if (args.size() != 1) {
+        throw BuiltinUnexpectedArgumentError(term, TimerBuiltins.Cancel);
+      }
+      return task.cancelSchedule(get_integer(term, args.at(0)));
+    }
+
+    auto periodic = builtin == KName::Builtin_Timer_Every;
+    const auto& name = periodic ? TimerBuiltins.Every : TimerBuiltins.Schedule;
+    if (args.size() != 2) {
+      throw BuiltinUnexpectedArgumentError(term, name);
+    }
+
+    auto ms = get_integer(term, args.at(0));
+    if (ms < 0 || (periodic && ms == 0)) {
+      throw InvalidOperationError(
+          term, periodic ? "Expected a positive interval."
+                         : "Expected a non-negative delay.");
+    }
+
+    if (!std::holds_alternative<k_lambda>(args.at(1))) {
+      throw InvalidOperationError(term,
+                                  "Expected a lambda in `" + name + "`.");
+    }
+
+    auto lambda =
+        getMethod(stream, frame, std::get<k_lambda>(args.at(1))->identifier);
+    auto snapshot = ExecutionContext::fork();
+    auto delay = std::chrono::milliseconds(ms);
+
+    return task.schedule(delay,
+                         periodic ? delay : std::chrono::milliseconds::zero(),
+                         [this, snapshot, lambda]() {
+                           runScheduledLambda(*snapshot, lambda);
+                         });
+  }
+
+  /// @brief Runs a lambda of a timer on the task pool. Each run starts from
+  /// a copy of the variables in scope when it was scheduled.
+  void runScheduledLambda(ExecutionContext& snapshot, const Method& lambda) {
+    std::shared_ptr<ExecutionContext> context;
+    {
+      ExecutionContext::Scope scope(snapshot);
+      context = ExecutionContext::fork();
+    }
+
+    ExecutionContext::Scope scope(*context);
+    callStack().top()->clearFlag(FrameFlags::InTry);
+
+    auto subframe = buildSubFrame(callStack().top(), true);
+    subframe->variables.setLayout(getLayout(lambda));
+    callStack().push(subframe);
+    streamStack().push(compiledStream(lambda));
+
+    try {
+      interpretStackFrame();
+    } catch (const KiwiError& e) {
+      std::cerr << "Uncaught error: ";
+      ErrorHandler::handleError(e);  // Fails only this run.
+    }
+  }
+
+  std::vector<k_int> getTaskIds(const Token& term, const k_value& value) {
+    if (!std::holds_alternative<k_list>(value)) {
+      throw ConversionError(term, "Expected a list of tasks.");
+    }
+
+    std::vector<k_int> ids;
+    std::unordered_set<k_int> seen;
+    for (const auto& item : std::get<k_list>(value)->view()) {
+      if (!std::holds_alternative<k_int>(item)) {
+        throw ConversionError(term, "Expected a task.");
+      }
+
+      auto id = std::get<k_int>(item);
+      if (!seen.insert(id).second) {
+        throw InvalidOperationError(term, "A task can only be awaited once.");
+      }
+      ids.push_back(id);
+    }
+
+    return ids;
+  }
+
   int interpret(Lexer& lexer) {
     auto stream = std::make_shared<TokenStream>(lexer.getAllTokens());
     return interpret(stream);
@@ -227,12 +773,12 @@ class Interpreter {
       return 0;
     }
 
-    callStack.push(std::make_shared<CallStackFrame>());
-    streamStack.push(stream);
+    callStack().push(std::make_shared<CallStackFrame>());
+    streamStack().push(stream);
 
     interpretStackFrame();
 
-    if (!preservingMainStackFrame && callStack.size() == 1) {
+    if (!preservingMainStackFrame && callStack().size() == 1) {
       popStack();
     }
 
@@ -243,7 +789,7 @@ class Interpreter {
   /// @return A stack frame.
   std::shared_ptr<CallStackFrame> popTop() {
     auto deadFrame = popStack();
-    auto topFrame = callStack.top();
+    auto topFrame = callStack().top();
     if (deadFrame->isErrorStateSet()) {
       topFrame->setErrorState(deadFrame->getErrorState());
     }
@@ -251,25 +797,39 @@ class Interpreter {
   }
 
   std::shared_ptr<CallStackFrame> popStack() {
-    streamStack.pop();
-    auto top = callStack.top();
-    callStack.pop();
+    streamStack().pop();
+    auto top = callStack().top();
+    callStack().pop();
     return top;
   }
 
   void interpretStackFrame() {
-    auto& frame = callStack.top();
-    auto& stream = streamStack.top();
+    auto& frame = callStack().top();
+    auto& stream = streamStack().top();
+    auto cancellation = CancellationToken::current();  // Null outside tasks.
 
     while (stream->canRead()) {
       try {
+        if (cancellation && cancellation->take()) {
+          throw TaskCancelledError(stream->current());
+        }
+
         interpretToken(stream, frame);
       } catch (const KiwiError& e) {
         if (frame->isFlagSet(FrameFlags::InTry)) {
           frame->setErrorState(e);
+        } else if (!ExecutionContext::current().isShared()) {
+          throw;  // Fails the task. The error is raised again by `await`.
         } else {
           handleUncaughtException(stream, e);
         }
+      } catch (const TaskCancelled&) {
+        // Thrown by a wait, which only happens in a task.
+        TaskCancelledError error(stream->current());
+        if (!frame->isFlagSet(FrameFlags::InTry)) {
+          throw error;
+        }
+        frame->setErrorState(error);
       } catch (const std::exception& e) {
         ErrorHandler::handleFatalError(e);
       }
@@ -279,7 +839,7 @@ class Interpreter {
       }
     }
 
-    if (callStack.size() < 2) {
+    if (callStack().size() < 2) {
       return;
     }
 
@@ -291,7 +851,7 @@ class Interpreter {
     ErrorHandler::handleError(e);
 
     if (!preservingMainStackFrame) {
-      while (task.hasActiveTasks()) {}
+      task.waitForAll();
       exit(1);
     } else {
       stream->next();
@@ -304,9 +864,13 @@ class Interpreter {
          hasReturn = frame->isFlagSet(FrameFlags::ReturnFlag);
 
     if (hasErrorState) {
-      ++streamStack.top()->position;
+      // Skip ahead to the `catch`, unless the error stopped right on it.
+      auto& stream = streamStack().top();
+      if (stream->current().getSubType() != KName::KW_Catch) {
+        ++stream->position;
+      }
     } else if (hasLoopControl || hasReturn) {
-      if (callStack.size() > 1) {
+      if (callStack().size() > 1) {
         if (hasLoopControl) {
           return handleLoopControl(frame);
         } else if (hasReturn) {
@@ -385,28 +949,16 @@ class Interpreter {
   std::shared_ptr<CallStackFrame> buildSubFrame(
       std::shared_ptr<CallStackFrame> frame, bool isMethodInvocation = false) {
     auto subFrame = std::make_shared<CallStackFrame>();
-    auto& subFrameVariables = subFrame->variables;
-    auto& subFrameLambdas = subFrame->lambdas;
 
+    // A block scope reads through to its enclosing scope and only stores
+    // what it assigns. Method scopes start empty.
     if (!isMethodInvocation) {
-      const auto& frameVariables = frame->variables;
-      for (const auto& pair : frameVariables) {
-        subFrameVariables[pair.first] = pair.second;
-      }
-      const auto& frameLambdas = frame->lambdas;
-      for (const auto& pair : frameLambdas) {
-        subFrameLambdas[pair.first] = pair.second;
-      }
+      subFrame->parent = frame;
     }
 
     if (frame->inObjectContext()) {
       const auto& objectContext = frame->getObjectContext();
-      const auto& objectContextInstanceVariables =
-          objectContext->instanceVariables;
-      for (const auto& pair : objectContextInstanceVariables) {
-        subFrameVariables[pair.first] = clone_value(pair.second);
-      }
-
+      subFrame->scopeObject = objectContext;
       subFrame->setObjectContext(objectContext);
     }
 
@@ -430,13 +982,10 @@ class Interpreter {
           return frame->getAssignedLambda(lambdaName);
         } 
         
-        auto tempStack(callStack);
-        while (!tempStack.empty()) {
-          auto& outerFrame = tempStack.top();
+        for (const auto& outerFrame : callStack()) {
           if (outerFrame->hasAssignedLambda(lambdaName)) {
             return outerFrame->getAssignedLambda(lambdaName);
           }
-          tempStack.pop();
         }
       } break;
 
@@ -487,9 +1036,14 @@ class Interpreter {
                          const k_string& itemVariableName,
                          const k_string& indexVariableName) {
     auto& collection = std::get<k_hash>(collectionValue);
-    const auto& keys = collection->keys;
-    auto& kvp = collection->kvp;
-    auto loopTokens = InterpHelper::collectBodyTokens(stream);
+    // Iterate a snapshot so writes in the body can't invalidate the keys.
+    auto snapshot = collection->clone();
+    const auto& keys = snapshot->keys();
+    k_tokens loopTokens = std::make_shared<const std::vector<Token>>(
+        InterpHelper::collectBodyTokens(stream));
+    auto expressions = std::make_shared<ExpressionCache>(
+        FrameLayout::resolve(*loopTokens, {itemVariableName, indexVariableName},
+                             frame->variables.getSharedLayout()));
 
     // Execute the loop
     for (const auto& key : keys) {
@@ -500,17 +1054,19 @@ class Interpreter {
           frame->clearFlag(FrameFlags::LoopContinue);
           continue;
         }
-      } else if (frame->isFlagSet(FrameFlags::ReturnFlag)) {
+      } else if (frame->isFlagSet(FrameFlags::ReturnFlag) ||
+                 frame->isErrorStateSet()) {
         break;
       }
 
       auto subframe = buildSubFrame(frame);
+      subframe->variables.setLayout(expressions->getLayout());
       subframe->variables[indexVariableName] = key;
       if (hasIndexVariable) {
-        subframe->variables[itemVariableName] = kvp[key];
+        subframe->variables[itemVariableName] = collection->get(key);
       }
-      callStack.push(subframe);
-      streamStack.push(std::make_shared<TokenStream>(loopTokens));
+      callStack().push(subframe);
+      streamStack().push(compiledStream(loopTokens, expressions));
 
       interpretStackFrame();
     }
@@ -521,9 +1077,16 @@ class Interpreter {
                          const k_string& itemVariableName,
                          const k_string& indexVariableName) {
     const auto& collection = std::get<k_list>(collectionValue);
-    const auto& elements = collection->elements;
+    collection->detach();
+    // Iterate a snapshot so writes in the body can't invalidate the elements.
+    auto snapshot = collection->clone();
+    const auto& elements = snapshot->view();
 
-    auto loopTokens = InterpHelper::collectBodyTokens(stream);
+    k_tokens loopTokens = std::make_shared<const std::vector<Token>>(
+        InterpHelper::collectBodyTokens(stream));
+    auto expressions = std::make_shared<ExpressionCache>(
+        FrameLayout::resolve(*loopTokens, {itemVariableName, indexVariableName},
+                             frame->variables.getSharedLayout()));
 
     // Execute the loop
     size_t index = 0;
@@ -534,18 +1097,20 @@ class Interpreter {
       }
 
       auto subframe = buildSubFrame(frame);
+      subframe->variables.setLayout(expressions->getLayout());
       subframe->variables[itemVariableName] = item;
       if (hasIndexVariable) {
         subframe->variables[indexVariableName] = static_cast<k_int>(index);
       }
 
-      callStack.push(subframe);
-      streamStack.push(std::make_shared<TokenStream>(loopTokens));
+      callStack().push(subframe);
+      streamStack().push(compiledStream(loopTokens, expressions));
 
       interpretStackFrame();
 
       if (frame->isFlagSet(FrameFlags::LoopBreak) ||
-          frame->isFlagSet(FrameFlags::ReturnFlag)) {
+          frame->isFlagSet(FrameFlags::ReturnFlag) ||
+          frame->isErrorStateSet()) {
         break;
       }
 
@@ -553,6 +1118,53 @@ class Interpreter {
     }
   }
 
+  static std::shared_ptr<FileReader> getReader(const k_value& value) {
+    if (!std::holds_alternative<k_handle>(value)) {
+      return nullptr;
+    }
+    return std::dynamic_pointer_cast<FileReader>(std::get<k_handle>(value));
+  }
+
+  // Pulls one line at a time, so the file is never held in memory whole.
+  void interpretReaderLoop(k_stream stream,
+                           std::shared_ptr<CallStackFrame> frame,
+                           const std::shared_ptr<FileReader>& reader,
+                           const bool& hasIndexVariable,
+                           const k_string& itemVariableName,
+                           const k_string& indexVariableName) {
+    k_tokens loopTokens = std::make_shared<const std::vector<Token>>(
+        InterpHelper::collectBodyTokens(stream));
+    auto expressions = std::make_shared<ExpressionCache>(
+        FrameLayout::resolve(*loopTokens, {itemVariableName, indexVariableName},
+                             frame->variables.getSharedLayout()));
+
+    k_string line;
+    size_t index = 0;
+    while (reader->readLine(line)) {
+      auto subframe = buildSubFrame(frame);
+      subframe->variables.setLayout(expressions->getLayout());
+      subframe->variables[itemVariableName] = std::move(line);
+      if (hasIndexVariable) {
+        subframe->variables[indexVariableName] = static_cast<k_int>(index);
+      }
+
+      callStack().push(subframe);
+      streamStack().push(compiledStream(loopTokens, expressions));
+
+      interpretStackFrame();
+
+      if (frame->isFlagSet(FrameFlags::LoopBreak) ||
+          frame->isFlagSet(FrameFlags::ReturnFlag) ||
+          frame->isErrorStateSet()) {
+        break;
+      }
+
+      // Cleared here, so that `next` does not also skip the following line.
+      frame->clearFlag(FrameFlags::LoopContinue);
+      index++;
+    }
+  }
+
   void interpretForLoop(k_stream stream,
                         std::shared_ptr<CallStackFrame> frame) {
     k_string itemVariableName, indexVariableName;
@@ -594,12 +1206,15 @@ class Interpreter {
     } else if (std::holds_alternative<k_hash>(collectionValue)) {
       interpretHashLoop(stream, frame, collectionValue, hasIndexVariable,
                         indexVariableName, itemVariableName);
+    } else if (auto reader = getReader(collectionValue)) {
+      interpretReaderLoop(stream, frame, reader, hasIndexVariable,
+                          itemVariableName, indexVariableName);
     } else {
       throw InvalidOperationError(stream->current(),
                                   "Term is not a List or Hash.");
     }
 
-    frame = callStack.top();
+    frame = callStack().top();
 
     for (const auto& pair : restore) {
       frame->variables[pair.first] = pair.second;
@@ -615,7 +1230,7 @@ class Interpreter {
     auto term = stream->current();
     while (stream->canRead() &&
            stream->current().getSubType() != KName::KW_Do) {
-      condition.emplace_back(std::move(stream->current()));
+      condition.emplace_back(stream->current());
       stream->next();
     }
 
@@ -625,9 +1240,16 @@ class Interpreter {
 
     stream->next();  // Skip "do"
 
-    auto loopTokens = InterpHelper::collectBodyTokens(stream);
+    k_tokens loopTokens = std::make_shared<const std::vector<Token>>(
+        InterpHelper::collectBodyTokens(stream));
     //auto oldFrame = std::make_shared<CallStackFrame>(*frame);
-    auto conditionStream = std::make_shared<TokenStream>(condition);
+    // The condition runs in a frame laid out like the body's.
+    auto layout = FrameLayout::resolve(*loopTokens, {},
+                                       frame->variables.getSharedLayout());
+    auto expressions = std::make_shared<ExpressionCache>(layout);
+    auto conditionStream = compiledStream(
+        std::make_shared<const std::vector<Token>>(std::move(condition)),
+        std::make_shared<ExpressionCache>(layout));
     auto& streamPosition = conditionStream->position;
 
     while (true) {
@@ -638,11 +1260,13 @@ class Interpreter {
           frame->clearFlag(FrameFlags::LoopContinue);
           continue;
         }
-      } else if (frame->isFlagSet(FrameFlags::ReturnFlag)) {
+      } else if (frame->isFlagSet(FrameFlags::ReturnFlag) ||
+                 frame->isErrorStateSet()) {
         break;
       }
 
       auto conditionFrame = buildSubFrame(frame);
+      conditionFrame->variables.setLayout(layout);
       auto value = parseExpression(conditionStream, conditionFrame);
       streamPosition = 0;
 
@@ -654,14 +1278,15 @@ class Interpreter {
         break;
       }
 
-      auto codeStream = std::make_shared<TokenStream>(loopTokens);
+      auto codeStream = compiledStream(loopTokens, expressions);
       auto codeFrame = buildSubFrame(frame);
+      codeFrame->variables.setLayout(layout);
       codeFrame->setFlag(FrameFlags::InLoop);
-      callStack.push(codeFrame);
-      streamStack.push(codeStream);
+      callStack().push(codeFrame);
+      streamStack().push(codeStream);
 
       interpretStackFrame();
-      frame = callStack.top();
+      frame = callStack().top();
     }
 
     frame->clearFlag(FrameFlags::LoopBreak);
@@ -753,15 +1378,15 @@ class Interpreter {
       if (std::holds_alternative<k_hash>(errorValue)) {
         auto errorHash = std::get<k_hash>(errorValue);
         if (errorHash->hasKey("error") &&
-            std::holds_alternative<k_string>(errorHash->kvp["error"])) {
-          errorType = std::get<k_string>(errorHash->kvp["error"]);
+            std::holds_alternative<k_text>(errorHash->get("error"))) {
+          errorType = std::get<k_text>(errorHash->get("error")).str();
         }
         if (errorHash->hasKey("message") &&
-            std::holds_alternative<k_string>(errorHash->kvp["message"])) {
-          errorMessage = std::get<k_string>(errorHash->kvp["message"]);
+            std::holds_alternative<k_text>(errorHash->get("message"))) {
+          errorMessage = std::get<k_text>(errorHash->get("message")).str();
         }
-      } else if (std::holds_alternative<k_string>(errorValue)) {
-        errorMessage = std::get<k_string>(errorValue);
+      } else if (std::holds_alternative<k_text>(errorValue)) {
+        errorMessage = std::get<k_text>(errorValue).str();
       }
     } else if (stream->current().getSubType() == KName::KW_When &&
                interpretWhen(stream, frame)) {
@@ -843,13 +1468,13 @@ class Interpreter {
 
     expression = parseExpression(stream, frame);
 
-    if (!std::holds_alternative<k_string>(expression)) {
+    if (!std::holds_alternative<k_text>(expression)) {
       throw InvalidOperationError(
           stream->current(),
           "Expected an string expression for parse operation.");
     }
 
-    interpretKiwi(std::get<k_string>(expression));
+    interpretKiwi(std::get<k_text>(expression).str());
   }
 
   void interpretKeyword(k_stream stream,
@@ -994,15 +1619,18 @@ class Interpreter {
             }
             return std::make_shared<LambdaRef>(identifier);
 
-          default:
-            interpretMethodInvocation(stream, frame, identifier);
-            break;
+          default: {
+            // An async method returns its task rather than a frame result.
+            auto result = interpretMethodInvocation(stream, frame, identifier);
+            frame->clearFlag(FrameFlags::ReturnFlag);
+            return result;
+          }
         }
       }
 
-      if (!callStack.empty()) {
+      if (!callStack().empty()) {
         frame->clearFlag(FrameFlags::ReturnFlag);
-        return callStack.top()->returnValue;
+        return callStack().top()->returnValue;
       }
     }
 
@@ -1049,6 +1677,9 @@ class Interpreter {
 
     auto tokenText = stream->current().getText();
     const auto& op = stream->current().getSubType();
+    auto symbol = stream->peek().getType() == KTokenType::QUALIFIER
+                      ? SymbolTable::None
+                      : stream->current().getSymbol();
 
     interpretQualifiedIdentifier(stream, tokenText);
 
@@ -1059,14 +1690,14 @@ class Interpreter {
       return static_cast<k_int>(0);
     }
 
-    if (InterpHelper::hasVariable(frame, tokenText)) {
+    if (auto variable = InterpHelper::findVariable(frame, symbol, tokenText)) {
       if (stream->peek().getType() == KTokenType::OPEN_BRACKET) {
         stream->next();
         interpretSliceAssignment(stream, frame, tokenText);
         return static_cast<k_int>(0);
       }
 
-      auto v = InterpHelper::getVariable(stream, frame, tokenText);
+      auto v = *variable;
       stream->next();
 
       if (std::holds_alternative<k_lambda>(v)) {
@@ -1126,17 +1757,17 @@ class Interpreter {
       auto& catchFrameVariables = catchFrame->variables;
 
       if (!errorVariableName.empty() &&
-          std::holds_alternative<k_string>(errorValue)) {
+          std::holds_alternative<k_text>(errorValue)) {
         catchFrameVariables[errorVariableName] = errorValue;
       }
 
       if (!errorTypeVariableName.empty() &&
-          std::holds_alternative<k_string>(errorType)) {
+          std::holds_alternative<k_text>(errorType)) {
         catchFrameVariables[errorTypeVariableName] = errorType;
       }
 
-      callStack.push(catchFrame);
-      streamStack.push(catchStream);
+      callStack().push(catchFrame);
+      streamStack().push(catchStream);
       interpretStackFrame();
       frame->clearFlag(FrameFlags::InTry);
       frame->clearErrorState();
@@ -1193,7 +1824,8 @@ class Interpreter {
   }
 
   bool hasHomedPackage(const k_string& homeName, const k_string& packageName) {
-    for (auto pair : packages) {
+    std::shared_lock<std::shared_mutex> lock(definitionsMutex);
+    for (auto& pair : packages) {
       if (pair.first == packageName && pair.second.hasHome() &&
           pair.second.getHome() == homeName) {
         return true;
@@ -1204,16 +1836,44 @@ class Interpreter {
   }
 
   bool hasPackage(const k_string& name) const {
+    std::shared_lock<std::shared_mutex> lock(definitionsMutex);
     return packages.find(name) != packages.end();
   }
 
   bool hasClass(const k_string& name) const {
+    std::shared_lock<std::shared_mutex> lock(definitionsMutex);
     return classes.find(name) != classes.end();
   }
 
+  /// @brief Finds a class that is known to be defined. Map nodes are stable,
+  /// so the reference outlives the lock.
+  const Class& getClass(const k_string& name) const {
+    std::shared_lock<std::shared_mutex> lock(definitionsMutex);
+    return classes.at(name);
+  }
+
+  /// @brief Looks up the method cached at a call site for a class.
+  /// @param site The position of the method name in the stream.
+  const Method* findCachedMethod(const k_stream& stream, size_t site,
+                                 const k_string& className) const {
+    const auto& expressions = stream->expressions;
+    if (!expressions) {
+      return nullptr;
+    }
+    return expressions->findMethod(site, className, classGeneration.load());
+  }
+
+  void cacheMethod(const k_stream& stream, size_t site,
+                   const k_string& className, const Method* method) {
+    if (const auto& expressions = stream->expressions) {
+      expressions->cacheMethod(site, className, classGeneration.load(),
+                               method);
+    }
+  }
+
   bool hasMethod(std::shared_ptr<CallStackFrame> frame, const k_string& name) {
     if (frame->inObjectContext()) {
-      auto clazz = classes[frame->getObjectContext()->className];
+      const auto& clazz = getClass(frame->getObjectContext()->className);
       if (clazz.hasMethod(name)) {
         return true;
       }
@@ -1223,12 +1883,14 @@ class Interpreter {
       return true;
     }
 
+    std::shared_lock<std::shared_mutex> lock(definitionsMutex);
     return methods.find(name) != methods.end();
   }
 
   Package getHomedPackage(k_stream stream, const k_string& homeName,
                           const k_string& packageName) {
-    for (auto pair : packages) {
+    std::shared_lock<std::shared_mutex> lock(definitionsMutex);
+    for (auto& pair : packages) {
       if (pair.first == packageName && pair.second.hasHome() &&
           pair.second.getHome() == homeName) {
         return pair.second;
@@ -1239,8 +1901,10 @@ class Interpreter {
   }
 
   Package getPackage(k_stream stream, const k_string& name) {
-    if (hasPackage(name)) {
-      return packages[name];
+    std::shared_lock<std::shared_mutex> lock(definitionsMutex);
+    auto package = packages.find(name);
+    if (package != packages.end()) {
+      return package->second;
     }
 
     throw PackageUndefinedError(stream->current(), name);
@@ -1250,9 +1914,9 @@ class Interpreter {
                    const k_string& name) {
     if (hasMethod(frame, name)) {
       if (frame->inObjectContext()) {
-        auto clazz = classes[frame->getObjectContext()->className];
-        if (clazz.hasMethod(name)) {
-          return clazz.getMethod(name);
+        const auto& clazz = getClass(frame->getObjectContext()->className);
+        if (auto method = clazz.findMethod(name)) {
+          return *method;
         }
 
         if (frame->hasAssignedLambda(name)) {
@@ -1264,21 +1928,21 @@ class Interpreter {
         return frame->getAssignedLambda(name);
       }
 
-      return methods[name];
+      std::shared_lock<std::shared_mutex> lock(definitionsMutex);
+      auto method = methods.find(name);
+      if (method != methods.end()) {
+        return method->second;
+      }
     }
 
     return getAssignedLambda(stream, name);
   }
 
   Method& getAssignedLambda(k_stream stream, const k_string& name) {
-    auto tempStack(callStack);
-
-    while (!tempStack.empty()) {
-      auto& outerFrame = tempStack.top();
+    for (const auto& outerFrame : callStack()) {
       if (outerFrame->hasAssignedLambda(name)) {
         return outerFrame->getAssignedLambda(name);
       }
-      tempStack.pop();
     }
 
     throw MethodUndefinedError(stream->current(), name);
@@ -1333,22 +1997,35 @@ class Interpreter {
   void handleWebServerRequest(int webhookID, k_hash requestHash,
                               k_string& redirect, k_string& content,
                               k_string& contentType, int& status) {
-    auto webhook = kiwiWebServerHooks[webhookID];
+    // Requests are served in parallel, each in a context of its own. The
+    // handler is only read, so every request can share it.
+    const auto& webhook = kiwiWebServerHooks.at(webhookID);
+    ExecutionContext::Pool::Lease lease(kiwiWebServerContexts);
+    ExecutionContext::Scope scope(lease.get());
+
     auto webhookFrame = std::make_shared<CallStackFrame>();
+    webhookFrame->variables.setLayout(getLayout(webhook));
 
     for (const auto& param : webhook.getParameters()) {
       webhookFrame->variables[param] = requestHash;
       break;
     }
 
-    auto webhookStream = std::make_shared<TokenStream>(webhook.getCode());
-    callStack.push(webhookFrame);
-    streamStack.push(webhookStream);
+    auto webhookStream = compiledStream(webhook);
+    callStack().push(std::make_shared<CallStackFrame>());  // Gets the result.
+    callStack().push(webhookFrame);
+    streamStack().push(webhookStream);
 
-    interpretStackFrame();
+    try {
+      interpretStackFrame();
+    } catch (const KiwiError& e) {
+      std::cerr << "Uncaught error: ";
+      ErrorHandler::handleError(e);
+      return;  // Fails only this request.
+    }
 
-    if (!callStack.empty()) {
-      auto retValue = callStack.top()->returnValue;
+    if (!callStack().empty()) {
+      auto retValue = callStack().top()->returnValue;
       if (std::holds_alternative<k_hash>(retValue)) {
 
         auto responseHash = std::get<k_hash>(retValue);
@@ -1359,8 +2036,8 @@ class Interpreter {
 
         if (responseHash->hasKey("content-type")) {
           auto responseHashContent = responseHash->get("content-type");
-          if (std::holds_alternative<k_string>(responseHashContent)) {
-            contentType = std::get<k_string>(responseHashContent);
+          if (std::holds_alternative<k_text>(responseHashContent)) {
+            contentType = std::get<k_text>(responseHashContent).str();
           }
         }
 
@@ -1373,8 +2050,8 @@ class Interpreter {
 
         if (responseHash->hasKey("redirect")) {
           auto responseHashContent = responseHash->get("redirect");
-          if (std::holds_alternative<k_string>(responseHashContent)) {
-            redirect = std::get<k_string>(responseHashContent);
+          if (std::holds_alternative<k_text>(responseHashContent)) {
+            redirect = std::get<k_text>(responseHashContent).str();
           }
         }
       }
@@ -1385,11 +2062,11 @@ class Interpreter {
                                                  k_value& arg) {
     std::vector<k_string> endpointList;
 
-    if (std::holds_alternative<k_string>(arg)) {
+    if (std::holds_alternative<k_text>(arg)) {
       endpointList.emplace_back(get_string(term, arg));
     } else if (std::holds_alternative<k_list>(arg)) {
-      for (const auto& el : std::get<k_list>(arg)->elements) {
-        if (std::holds_alternative<k_string>(el)) {
+      for (const auto& el : std::get<k_list>(arg)->elements()) {
+        if (std::holds_alternative<k_text>(el)) {
           auto endpoint = get_string(term, el);
           if (std::find(endpointList.begin(), endpointList.end(), endpoint) ==
               endpointList.end()) {
@@ -1577,6 +2254,29 @@ class Interpreter {
     return true;
   }
 
+  k_value interpretWebServerThreads(k_stream stream,
+                                    const std::vector<k_value>& args) {
+    const auto& term = stream->current();
+    if (args.size() != 1) {
+      throw BuiltinUnexpectedArgumentError(term, WebServerBuiltins.Threads);
+    }
+
+    auto count = get_integer(term, args.at(0));
+    if (count < 0) {
+      throw InvalidOperationError(term,
+                                  "Expected a non-negative thread count.");
+    } else if (count == 0) {
+      count = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Read when the server starts listening.
+    kiwiWebServer.new_task_queue = [count]() {
+      return new httplib::ThreadPool(static_cast<size_t>(count));
+    };
+
+    return count;
+  }
+
   k_value interpretWebServerHost(k_stream stream,
                                  const std::vector<k_value>& args) {
     if (args.size() != 0) {
@@ -1610,6 +2310,9 @@ class Interpreter {
       case KName::Builtin_WebServer_Public:
         return interpretWebServerPublic(stream, args);
 
+      case KName::Builtin_WebServer_Threads:
+        return interpretWebServerThreads(stream, args);
+
       default:
         break;
     }
@@ -1665,19 +2368,21 @@ class Interpreter {
                                              PackageBuiltins.Home);
       }
 
-      if (!std::holds_alternative<k_string>(args.at(0))) {
+      if (!std::holds_alternative<k_text>(args.at(0))) {
         throw SyntaxError(stream->current(), "Expected string value for `" +
                                                  PackageBuiltins.Home +
                                                  "` builtin parameter.");
       }
 
-      packages[packageName].setHome(std::get<k_string>(args.at(0)));
+      std::unique_lock<std::shared_mutex> lock(definitionsMutex);
+      packages[packageName].setHome(std::get<k_text>(args.at(0)).str());
       packages[packageName].setName(packageName);
     }
   }
 
-  std::vector<k_string> collectMethodParameters(
-      k_stream stream, std::shared_ptr<CallStackFrame> frame, Method& method) {
+  std::unordered_map<k_string, k_value> collectMethodParameters(
+      k_stream stream, std::shared_ptr<CallStackFrame> frame,
+      const Method& method) {
     if (!stream->match(KTokenType::OPEN_PAREN)) {
       throw SyntaxError(
           stream->current(),
@@ -1685,8 +2390,9 @@ class Interpreter {
     }
 
     // Interpret parameters.
-    auto parameters = method.getParameters();
-    int paramIndex = 0;
+    const auto& parameters = method.getParameters();
+    std::unordered_map<k_string, k_value> values;
+    size_t paramIndex = 0;
 
     bool closeParenthesisFound = false;
     while (stream->canRead() &&
@@ -1702,7 +2408,7 @@ class Interpreter {
         closeParenthesisFound = true;
       }
 
-      method.addParameterValue(parameters.at(paramIndex++), paramValue);
+      values[parameters.at(paramIndex++)] = paramValue;
 
       if (!closeParenthesisFound) {
         stream->next();
@@ -1710,24 +2416,31 @@ class Interpreter {
     }
     stream->next();  // Skip ")"
 
-    return parameters;
+    return values;
   }
 
   std::shared_ptr<CallStackFrame> buildMethodInvocationStackFrame(
-      k_stream stream, std::shared_ptr<CallStackFrame> frame, Method& method) {
-    auto parameters = collectMethodParameters(stream, frame, method);
+      k_stream stream, std::shared_ptr<CallStackFrame> frame,
+      const Method& method) {
+    auto values = collectMethodParameters(stream, frame, method);
     auto codeFrame = buildSubFrame(frame, true);
     auto& codeFrameVariables = codeFrame->variables;
+    codeFrameVariables.setLayout(getLayout(method));
 
-    for (const auto& pair : frame->lambdas) {
-      // Check this.
-      codeFrame->assignLambda(pair.first, pair.second);
+    for (auto scope = frame.get(); scope; scope = scope->parent.get()) {
+      for (const auto& pair : scope->lambdas) {
+        // Check this.
+        if (!codeFrame->hasAssignedLambda(pair.first)) {
+          codeFrame->assignLambda(pair.first, pair.second);
+        }
+      }
     }
 
     // Check all parameters are passed.
-    for (const k_string& parameterName : parameters) {
-      if (!method.hasParameter(parameterName)) {
-        auto param = method.getParameter(parameterName);
+    for (const k_string& parameterName : method.getParameters()) {
+      auto value = values.find(parameterName);
+      if (value == values.end()) {
+        const auto& param = method.getParameter(parameterName);
 
         if (!param.hasDefaultValue()) {
           throw ParameterMissingError(stream->current(), parameterName);
@@ -1735,8 +2448,7 @@ class Interpreter {
 
         codeFrameVariables[parameterName] = clone_value(param.getValue());
       } else {
-        codeFrameVariables[parameterName] =
-            clone_value(method.getParameterValue(parameterName));
+        codeFrameVariables[parameterName] = clone_value(value->second);
       }
     }
     codeFrame->setFlag(FrameFlags::SubFrame);
@@ -1750,31 +2462,33 @@ class Interpreter {
     stream->next();  // Skip class name
     stream->next();  // Skip the "."
 
-    auto memberTerm = stream->current();
-    auto methodName = memberTerm.getText();
+    auto site = stream->position;
+    auto methodName = stream->current().getText();
     stream->next();  // Skip the method name.
 
-    auto clazz = classes[className];
-    bool isInstantiation = false;
+    bool isInstantiation = methodName == Keywords.New;
+    if (isInstantiation) {
+      methodName = Keywords.Ctor;
+    }
 
-    if (methodName == Keywords.New) {
-      if (clazz.isAbstract()) {
+    auto cached = findCachedMethod(stream, site, className);
+    if (!cached) {
+      const auto& clazz = getClass(className);
+      if (isInstantiation && clazz.isAbstract()) {
         throw InvalidOperationError(stream->current(),
                                     "Cannot instantiate an abstract class.");
       }
 
-      if (!clazz.hasMethod(Keywords.Ctor)) {
+      cached = clazz.findMethod(methodName);
+      if (!cached) {
         throw UnimplementedMethodError(stream->current(), className,
-                                       Keywords.Ctor);
+                                       methodName);
       }
 
-      methodName = Keywords.Ctor;
-      isInstantiation = true;
-    } else if (!clazz.hasMethod(methodName)) {
-      throw UnimplementedMethodError(stream->current(), className, methodName);
+      cacheMethod(stream, site, className, cached);
     }
 
-    auto method = clazz.getMethod(methodName);
+    const auto& method = *cached;
     if (!method.isFlagSet(MethodFlags::Static) &&
         !method.isFlagSet(MethodFlags::Ctor)) {
       throw InvalidContextError(
@@ -1793,21 +2507,21 @@ class Interpreter {
       }
     }
 
-    auto codeStream = std::make_shared<TokenStream>(method.getCode());
+    auto codeStream = compiledStream(method);
     auto codeFrame = buildMethodInvocationStackFrame(stream, frame, method);
     if (isInstantiation) {
       auto context = std::make_shared<Object>();
       context->className = className;
       codeFrame->setObjectContext(context);
     }
-    callStack.push(codeFrame);
-    streamStack.push(codeStream);
+    callStack().push(codeFrame);
+    streamStack().push(codeStream);
 
     // Now interpret the method in its own context
     interpretStackFrame();
 
-    if (!callStack.empty()) {
-      return callStack.top()->returnValue;
+    if (!callStack().empty()) {
+      return callStack().top()->returnValue;
     }
 
     throw EmptyStackError(stream->current());
@@ -1816,22 +2530,29 @@ class Interpreter {
   k_value interpretInstanceMethodInvocation(
       k_stream stream, std::shared_ptr<CallStackFrame> frame, k_object& object,
       const k_string& methodName, const KName& op,
-      std::vector<k_value>& parameters) {
-    if (!hasClass(object->className)) {
-      throw ClassUndefinedError(stream->current(), object->className);
-    }
+      std::vector<k_value>& parameters, size_t site = FrameLayout::npos) {
+    auto cached = findCachedMethod(stream, site, object->className);
+    if (!cached) {
+      std::shared_lock<std::shared_mutex> lock(definitionsMutex);
+      auto clazz = classes.find(object->className);
+      if (clazz == classes.end()) {
+        throw ClassUndefinedError(stream->current(), object->className);
+      }
 
-    auto clazz = classes[object->className];
-    if (!clazz.hasMethod(methodName)) {
-      if (KiwiBuiltins.is_builtin(op)) {
-        return BuiltinDispatch::execute(stream->current(), op, object,
-                                        parameters);
+      cached = clazz->second.findMethod(methodName);
+      if (!cached) {
+        if (KiwiBuiltins.is_builtin(op)) {
+          return BuiltinDispatch::execute(stream->current(), op, object,
+                                          parameters);
+        }
+        throw UnimplementedMethodError(stream->current(), object->className,
+                                       methodName);
       }
-      throw UnimplementedMethodError(stream->current(), object->className,
-                                     methodName);
+
+      cacheMethod(stream, site, object->className, cached);
     }
 
-    auto method = clazz.getMethod(methodName);
+    const auto& method = *cached;
 
     if (method.isFlagSet(MethodFlags::Private) && !frame->inObjectContext()) {
       throw InvalidContextError(
@@ -1839,9 +2560,10 @@ class Interpreter {
           "Cannot invoke private method outside of object context.");
     }
 
-    auto codeStream = std::make_shared<TokenStream>(method.getCode());
+    auto codeStream = compiledStream(method);
     auto codeFrame = buildSubFrame(frame);
     auto& codeFrameVariables = codeFrame->variables;
+    codeFrameVariables.setLayout(getLayout(method));
 
     if (static_cast<int>(parameters.size()) != method.getParameterCount()) {
       throw ParameterCountMismatchError(stream->current(), methodName);
@@ -1855,14 +2577,14 @@ class Interpreter {
     }
     codeFrame->setFlag(FrameFlags::SubFrame);
     codeFrame->setObjectContext(object);
-    callStack.push(codeFrame);
-    streamStack.push(codeStream);
+    callStack().push(codeFrame);
+    streamStack().push(codeStream);
 
     interpretStackFrame();
 
-    if (!callStack.empty()) {
+    if (!callStack().empty()) {
       frame->clearFlag(FrameFlags::ReturnFlag);
-      return callStack.top()->returnValue;
+      return callStack().top()->returnValue;
     }
 
     return {};
@@ -1871,7 +2593,8 @@ class Interpreter {
   void interpretInstanceMethodInvocation(k_stream stream,
                                          std::shared_ptr<CallStackFrame> frame,
                                          const k_string& instanceName,
-                                         k_string methodName = "") {
+                                         k_string methodName = "",
+                                         size_t site = FrameLayout::npos) {
     if (methodName.empty()) {
       stream->next();  // Skip the "."
       if (stream->current().getType() != KTokenType::IDENTIFIER) {
@@ -1881,6 +2604,7 @@ class Interpreter {
                               stream->current().getText() + "`");
       }
 
+      site = stream->position;
       methodName = stream->current().getText();
       stream->next();  // Skip the method name.
     }
@@ -1888,17 +2612,24 @@ class Interpreter {
     auto object = std::get<k_object>(
         InterpHelper::getVariable(stream, frame, instanceName));
 
-    if (!hasClass(object->className)) {
-      throw ClassUndefinedError(stream->current(), object->className);
-    }
+    auto cached = findCachedMethod(stream, site, object->className);
+    if (!cached) {
+      std::shared_lock<std::shared_mutex> lock(definitionsMutex);
+      auto clazz = classes.find(object->className);
+      if (clazz == classes.end()) {
+        throw ClassUndefinedError(stream->current(), object->className);
+      }
+
+      cached = clazz->second.findMethod(methodName);
+      if (!cached) {
+        throw UnimplementedMethodError(stream->current(), object->className,
+                                       methodName);
+      }
 
-    auto clazz = classes[object->className];
-    if (!clazz.hasMethod(methodName)) {
-      throw UnimplementedMethodError(stream->current(), object->className,
-                                     methodName);
+      cacheMethod(stream, site, object->className, cached);
     }
 
-    auto method = clazz.getMethod(methodName);
+    const auto& method = *cached;
 
     if (method.isFlagSet(MethodFlags::Private) && !frame->inObjectContext()) {
       throw InvalidContextError(
@@ -1906,11 +2637,11 @@ class Interpreter {
           "Cannot invoke private method outside of object context.");
     }
 
-    auto codeStream = std::make_shared<TokenStream>(method.getCode());
+    auto codeStream = compiledStream(method);
     auto codeFrame = buildMethodInvocationStackFrame(stream, frame, method);
     codeFrame->setObjectContext(object);
-    callStack.push(codeFrame);
-    streamStack.push(codeStream);
+    callStack().push(codeFrame);
+    streamStack().push(codeStream);
 
     interpretStackFrame();
   }
@@ -1942,13 +2673,13 @@ class Interpreter {
       }
     }
 
-    auto loopStream = std::make_shared<TokenStream>(then.getCode());
-    callStack.push(buildSubFrame(frame, true));
-    streamStack.push(loopStream);
+    auto loopStream = compiledStream(then);
+    callStack().push(buildSubFrame(frame, true));
+    streamStack().push(loopStream);
     interpretStackFrame();
 
-    if (!callStack.empty()) {
-      auto value = callStack.top()->returnValue;
+    if (!callStack().empty()) {
+      auto value = callStack().top()->returnValue;
       frame->clearFlag(FrameFlags::ReturnFlag);
 
       return value;
@@ -1978,23 +2709,23 @@ class Interpreter {
     if (method.isFlagSet(MethodFlags::Async)) {
       auto taskId = interpretAsyncMethodInvocation(codeFrame, method);
 
-      if (!await && stream->current().getSubType() == KName::KW_Then) {
+      if (stream->current().getSubType() != KName::KW_Then) {
+        return taskId;  // Runs alongside the caller until awaited.
+      } else if (!await) {
         return interpretThen(stream, frame, taskId);
-      } else if (await && stream->current().getSubType() != KName::KW_Then) {
-        return taskId;
       }
 
       throw SyntaxError(stream->current(),
                         "Invalid syntax in asynchronous invocation.");
     }
 
-    callStack.push(codeFrame);
-    streamStack.push(std::make_shared<TokenStream>(method.getCode()));
+    callStack().push(codeFrame);
+    streamStack().push(compiledStream(method));
 
     interpretStackFrame();
 
-    if (!callStack.empty()) {
-      return callStack.top()->returnValue;
+    if (!callStack().empty()) {
+      return callStack().top()->returnValue;
     }
 
     return {};
@@ -2128,6 +2859,7 @@ class Interpreter {
 
     auto method = interpretMethodDefinition(stream, frame);
     method.setFlag(MethodFlags::Async);
+    std::unique_lock<std::shared_mutex> lock(definitionsMutex);
     methods[method.getName()] = method;
   }
 
@@ -2137,8 +2869,8 @@ class Interpreter {
     auto name = method.getName();
     k_string packageName;
 
-    if (!packageStack.empty()) {
-      packageName = packageStack.top();
+    if (!packageStack().empty()) {
+      packageName = packageStack().top();
     }
 
     if (!packageName.empty()) {
@@ -2150,7 +2882,10 @@ class Interpreter {
     }
 
     method.setName(name);
-    methods[name] = method;
+    {
+      std::unique_lock<std::shared_mutex> lock(definitionsMutex);
+      methods[name] = method;
+    }
 
     return method;
   }
@@ -2168,10 +2903,13 @@ class Interpreter {
 
     if (std::holds_alternative<k_list>(listValue)) {
       slice.stopIndex =
-          static_cast<k_int>(std::get<k_list>(listValue)->elements.size());
-    } else if (std::holds_alternative<k_string>(listValue)) {
+          static_cast<k_int>(std::get<k_list>(listValue)->view().size());
+    } else if (std::holds_alternative<k_text>(listValue)) {
       slice.stopIndex =
-          static_cast<k_int>(std::get<k_string>(listValue).size());
+          static_cast<k_int>(std::get<k_text>(listValue).str().size());
+    } else if (std::holds_alternative<k_bytes>(listValue)) {
+      slice.stopIndex =
+          static_cast<k_int>(std::get<k_bytes>(listValue)->size());
     }
 
     slice.stepValue = static_cast<k_int>(1);
@@ -2242,11 +2980,11 @@ class Interpreter {
                         std::shared_ptr<CallStackFrame> frame) {
     auto output = interpretKeyOrIndex(stream, frame);
 
-    if (!std::holds_alternative<k_string>(output)) {
+    if (!std::holds_alternative<k_text>(output)) {
       throw SyntaxError(stream->current(), "Hash key must be a string value.");
     }
 
-    return std::get<k_string>(output);
+    return std::get<k_text>(output).str();
   }
 
   int interpretIndex(k_stream stream, std::shared_ptr<CallStackFrame> frame) {
@@ -2276,13 +3014,15 @@ class Interpreter {
   k_value interpretSlice(k_stream stream, k_value& value, SliceIndex& slice) {
     if (std::holds_alternative<k_list>(value)) {
       return InterpHelper::listSlice(stream, slice, value);
-    } else if (std::holds_alternative<k_string>(value)) {
+    } else if (std::holds_alternative<k_text>(value)) {
       return InterpHelper::stringSlice(stream, slice, value);
+    } else if (std::holds_alternative<k_bytes>(value)) {
+      return InterpHelper::bytesSlice(stream, slice, value);
     }
 
     throw ConversionError(
         stream->current(),
-        "Expected a `List` or a `String` for slice operation.");
+        "Expected a `List`, a `String` or `Bytes` for slice operation.");
   }
 
   k_value interpretSlice(k_stream stream, std::shared_ptr<CallStackFrame> frame,
@@ -2293,7 +3033,8 @@ class Interpreter {
     }
 
     if (!std::holds_alternative<k_list>(value) &&
-        !std::holds_alternative<k_string>(value)) {
+        !std::holds_alternative<k_text>(value) &&
+        !std::holds_alternative<k_bytes>(value)) {
       throw InvalidOperationError(
           stream->current(), "`" + name + "` is not a `List` or a `String`.");
     }
@@ -2335,7 +3076,7 @@ class Interpreter {
     auto i = start;
 
     auto list = std::make_shared<List>();
-    auto& elements = list->elements;
+    auto& elements = list->elements();
 
     for (; i != stop; i += step) {
       elements.emplace_back(i);
@@ -2356,14 +3097,14 @@ class Interpreter {
            stream->current().getType() != KTokenType::CLOSE_BRACE) {
       auto keyValue = parseExpression(stream, frame);
 
-      if (!std::holds_alternative<k_string>(keyValue)) {
+      if (!std::holds_alternative<k_text>(keyValue)) {
         throw SyntaxError(stream->current(),
                           "Hash key must be a string value.");
       }
 
       if (stream->current().getType() == KTokenType::COLON) {
         stream->next();  // Skip the ":"
-        hash->add(std::get<k_string>(keyValue), parseExpression(stream, frame));
+        hash->add(std::get<k_text>(keyValue).str(), parseExpression(stream, frame));
       }
 
       if (stream->current().getType() == KTokenType::COMMA) {
@@ -2380,7 +3121,7 @@ class Interpreter {
 
   k_list interpretList(k_stream stream, std::shared_ptr<CallStackFrame> frame) {
     auto list = std::make_shared<List>();
-    auto& elements = list->elements;
+    auto& elements = list->elements();
     stream->next();  // Skip "["
     int bracketCount = 1;
 
@@ -2504,37 +3245,41 @@ class Interpreter {
     }
 
     if (conditional.getIfStatement().isExecutable()) {
-      execute(frame, conditional.getIfStatement().getCode());
+      execute(frame, std::move(conditional.getIfStatement().getCode()));
     } else if (conditional.canExecuteElseIf()) {
       for (auto& elseIf : conditional.getElseIfStatements()) {
         if (elseIf.isExecutable()) {
-          execute(frame, elseIf.getCode());
+          execute(frame, std::move(elseIf.getCode()));
           break;
         }
       }
     } else {
-      execute(frame, conditional.getElseStatement().getCode());
+      execute(frame,
+              std::move(conditional.getElseStatement().getCode()));
     }
   }
 
   void execute(std::shared_ptr<CallStackFrame> frame,
-               const std::vector<Token>& executableTokens) {
+               std::vector<Token>&& executableTokens) {
     if (executableTokens.empty()) {
       return;
     }
 
-    callStack.push(buildSubFrame(frame));
-    streamStack.push(std::make_shared<TokenStream>(executableTokens));
+    callStack().push(buildSubFrame(frame));
+    streamStack().push(
+        std::make_shared<TokenStream>(std::move(executableTokens)));
     interpretStackFrame();
   }
 
   void execute(std::shared_ptr<CallStackFrame> frame, k_stream stream) {
-    callStack.push(buildSubFrame(frame));
-    streamStack.push(stream);
+    callStack().push(buildSubFrame(frame));
+    streamStack().push(stream);
     interpretStackFrame();
 
-    for (const auto& alias : callStack.top()->aliases) {
+    std::unique_lock<std::shared_mutex> lock(definitionsMutex);
+    for (const auto& alias : callStack().top()->aliases) {
       classes.erase(alias);
+      ++classGeneration;
     }
   }
 
@@ -2585,7 +3330,7 @@ class Interpreter {
       }
 
       // inherit methods from base class.
-      for (const auto& pair : classes[baseClassName].getMethods()) {
+      for (const auto& pair : getClass(baseClassName).getMethods()) {
         clazz.addMethod(pair.second);
       }
     }
@@ -2657,7 +3402,9 @@ class Interpreter {
       }
     }
 
+    std::unique_lock<std::shared_mutex> lock(definitionsMutex);
     classes[className] = std::move(clazz);
+    ++classGeneration;
   }
 
   void interpretPackageDefinition(k_stream stream) {
@@ -2689,6 +3436,7 @@ class Interpreter {
       stream->next();
     }
 
+    std::unique_lock<std::shared_mutex> lock(definitionsMutex);
     packages[name] = std::move(package);
   }
 
@@ -2696,29 +3444,29 @@ class Interpreter {
                                   const k_string& name) {
     stream->next();  // Skip the name.
 
-    packageStack.push(name);
+    packageStack().push(name);
     auto package = hasHomedPackage(home, name)
                        ? getHomedPackage(stream, home, name)
                        : getPackage(stream, name);
 
-    auto codeStream = std::make_shared<TokenStream>(package.getCode());
+    auto codeStream = std::make_shared<TokenStream>(package.getTokens());
     auto codeFrame = std::make_shared<CallStackFrame>();
-    callStack.push(codeFrame);
-    streamStack.push(codeStream);
+    callStack().push(codeFrame);
+    streamStack().push(codeStream);
     interpretStackFrame();
-    packageStack.pop();
+    packageStack().pop();
     return name;
   }
 
   k_string interpretExternalImport(k_stream stream,
                                    std::shared_ptr<CallStackFrame> frame) {
     auto scriptNameValue = parseExpression(stream, frame);
-    if (!std::holds_alternative<k_string>(scriptNameValue)) {
+    if (!std::holds_alternative<k_text>(scriptNameValue)) {
       throw ConversionError(stream->current(),
                             "Expected a string for `import` statement.");
     }
 
-    auto scriptName = std::get<k_string>(scriptNameValue);
+    auto scriptName = std::get<k_text>(scriptNameValue).str();
     auto scriptNameKiwi = scriptName;
 
     if (!String::endsWith(scriptName, kiwi_extension) &&
@@ -2748,8 +3496,8 @@ class Interpreter {
     execute(frame, lexer.getTokenStream());
 
     // Check if a package was imported.
-    if (std::holds_alternative<k_string>(frame->returnValue)) {
-      auto packageName = std::get<k_string>(frame->returnValue);
+    if (std::holds_alternative<k_text>(frame->returnValue)) {
+      auto packageName = std::get<k_text>(frame->returnValue).str();
 
       if (!hasPackage(packageName)) {
         packageName.clear();
@@ -2778,7 +3526,8 @@ class Interpreter {
     Class clazz;
     clazz.setClassName(alias);
 
-    for (auto pair : methods) {
+    std::unique_lock<std::shared_mutex> lock(definitionsMutex);
+    for (const auto& pair : methods) {
       auto name = pair.first;
       if (String::beginsWith(name, search)) {
         auto method = pair.second;
@@ -2789,8 +3538,9 @@ class Interpreter {
     }
 
     classes[alias] = clazz;
+    ++classGeneration;
 
-    for (auto pair : clazz.getMethods()) {
+    for (const auto& pair : clazz.getMethods()) {
       methods.erase(pair.first);
     }
 
@@ -2852,7 +3602,7 @@ class Interpreter {
                                 const k_string& name, k_value& value) {
     int index = interpretIndex(stream, frame);
     auto list = std::get<k_list>(value);
-    auto& elements = list->elements;
+    auto& elements = list->elements();
 
     if (index < 0 || index >= static_cast<int>(elements.size())) {
       throw RangeError(stream->current(), "List index out of range.");
@@ -2873,7 +3623,7 @@ class Interpreter {
         throw VariableUndefinedError(stream->current(), name);
       }
 
-      auto value = frame->variables.at(name);
+      auto value = InterpHelper::getVariable(stream, frame, name);
 
       if (stream->current().getType() == KTokenType::OPEN_BRACKET) {
         if (std::holds_alternative<k_hash>(value)) {
@@ -2940,16 +3690,24 @@ class Interpreter {
     auto args = interpretArguments(stream, frame);
 
     if (PackageBuiltins.is_builtin(builtin)) {
-      if (packageStack.empty()) {
+      if (packageStack().empty()) {
         throw InvalidContextError(term, "Expected a package context.");
       }
-      auto packageName = packageStack.top();
+      auto packageName = packageStack().top();
       interpretPackageBuiltin(stream, packageName, builtin, args);
       return static_cast<k_int>(0);
     } else if (WebServerBuiltins.is_builtin(builtin)) {
       return interpretWebServerBuiltin(stream, frame, builtin, args);
     } else if (SerializerBuiltins.is_builtin(builtin)) {
       return interpretSerializerBuiltin(stream, frame, builtin, args);
+    } else if (TaskBuiltins.is_builtin(builtin)) {
+      return interpretTaskBuiltin(stream, builtin, args);
+    } else if (TimerBuiltins.is_builtin(builtin)) {
+      return interpretTimerBuiltin(stream, frame, builtin, args);
+    } else if (ChannelBuiltins.is_builtin(builtin)) {
+      return interpretChannelBuiltin(stream, builtin, args);
+    } else if (ConcurrentBuiltins.is_builtin(builtin)) {
+      return interpretConcurrentBuiltin(stream, builtin, args);
     }
 
     frame->returnValue =
@@ -2974,7 +3732,7 @@ class Interpreter {
     if (stream->current().getType() == KTokenType::CLOSE_PAREN) {
       stream->next();
 
-      if (list->elements.empty()) {
+      if (list->view().empty()) {
         throw EmptyListError(stream->current());
       }
 
@@ -2990,7 +3748,7 @@ class Interpreter {
     if (stream->current().getType() == KTokenType::CLOSE_PAREN) {
       stream->next();  // Skip ")"
 
-      if (list->elements.empty()) {
+      if (list->view().empty()) {
         throw EmptyListError(stream->current());
       }
 
@@ -3037,16 +3795,17 @@ class Interpreter {
                             ListBuiltins.Each);
 
     size_t index = 0;
-    for (const auto& item : list->elements) {
+    for (const auto& item : list->elements()) {
       auto subframe = buildSubFrame(frame, true);
+      subframe->variables.setLayout(getLayout(lambda));
       subframe->variables[itemVariableName] = clone_value(item);
 
       if (hasIndexVariable) {
         subframe->variables[indexVariableName] = static_cast<k_int>(index++);
       }
 
-      callStack.push(subframe);
-      streamStack.push(std::make_shared<TokenStream>(lambda.getCode()));
+      callStack().push(subframe);
+      streamStack().push(compiledStream(lambda));
       interpretStackFrame();
     }
 
@@ -3057,7 +3816,7 @@ class Interpreter {
                               std::shared_ptr<CallStackFrame> frame,
                               const k_list& list) {
     return std::get<k_list>(interpretLambdaSelect(stream, frame, list))
-        ->elements.empty();
+        ->view().empty();
   }
 
   k_value interpretLambdaMap(k_stream stream,
@@ -3084,22 +3843,23 @@ class Interpreter {
                             ListBuiltins.Map);
 
     auto mappedList = std::make_shared<List>();
-    auto& elements = mappedList->elements;
+    auto& elements = mappedList->elements();
     size_t index = 0;
 
-    for (const auto& item : list->elements) {
+    for (const auto& item : list->elements()) {
       auto subframe = buildSubFrame(frame, true);
+      subframe->variables.setLayout(getLayout(lambda));
       subframe->variables[itemVariableName] = clone_value(item);
       if (hasIndexVariable) {
         subframe->variables[indexVariableName] = static_cast<k_int>(index++);
       }
 
-      callStack.push(subframe);
-      streamStack.push(std::make_shared<TokenStream>(lambda.getCode()));
+      callStack().push(subframe);
+      streamStack().push(compiledStream(lambda));
       interpretStackFrame();
 
-      if (!callStack.empty()) {
-        auto value = callStack.top()->returnValue;
+      if (!callStack().empty()) {
+        auto value = callStack().top()->returnValue;
         frame->clearFlag(FrameFlags::ReturnFlag);
         elements.emplace_back(clone_value(value));
       }
@@ -3141,20 +3901,21 @@ class Interpreter {
                             indexVariableName, hasIndexVariable,
                             ListBuiltins.Reduce);
 
-    for (const auto& item : list->elements) {
+    for (const auto& item : list->elements()) {
       auto subframe = buildSubFrame(frame, true);
+      subframe->variables.setLayout(getLayout(lambda));
 
       subframe->variables[accumulatorName] = accumulator;
       if (hasIndexVariable) {
         subframe->variables[indexVariableName] = item;
       }
 
-      callStack.push(subframe);
-      streamStack.push(std::make_shared<TokenStream>(lambda.getCode()));
+      callStack().push(subframe);
+      streamStack().push(compiledStream(lambda));
       interpretStackFrame();
 
-      if (!callStack.empty()) {
-        auto value = callStack.top()->returnValue;
+      if (!callStack().empty()) {
+        auto value = callStack().top()->returnValue;
         frame->clearFlag(FrameFlags::ReturnFlag);
         accumulator = clone_value(value);
       }
@@ -3187,22 +3948,23 @@ class Interpreter {
                             ListBuiltins.Select);
 
     auto filteredList = std::make_shared<List>();
-    auto& elements = filteredList->elements;
+    auto& elements = filteredList->elements();
 
     size_t index = 0;
-    for (const auto& item : list->elements) {
+    for (const auto& item : list->elements()) {
       auto subframe = buildSubFrame(frame, true);
+      subframe->variables.setLayout(getLayout(lambda));
       subframe->variables[itemVariableName] = item;
       if (hasIndexVariable) {
         subframe->variables[indexVariableName] = static_cast<k_int>(index++);
       }
 
-      callStack.push(subframe);
-      streamStack.push(std::make_shared<TokenStream>(lambda.getCode()));
+      callStack().push(subframe);
+      streamStack().push(compiledStream(lambda));
       interpretStackFrame();
 
-      if (!callStack.empty()) {
-        auto value = callStack.top()->returnValue;
+      if (!callStack().empty()) {
+        auto value = callStack().top()->returnValue;
         frame->clearFlag(FrameFlags::ReturnFlag);
 
         if (std::holds_alternative<bool>(value) && std::get<bool>(value)) {
@@ -3214,6 +3976,236 @@ class Interpreter {
     return filteredList;
   }
 
+  // Chunks per worker, so a slow chunk doesn't leave the others idle.
+  static constexpr size_t ChunksPerWorker = 4;
+
+  k_value interpretParallelEach(k_stream stream,
+                                std::shared_ptr<CallStackFrame> frame,
+                                const k_list& list) {
+    auto lambda = getListLambda(stream, frame, ListBuiltins.ParallelEach);
+
+    k_string itemVariableName, indexVariableName;
+    auto hasIndexVariable = false;
+    processLambdaParameters(stream, lambda.getParameters(), itemVariableName,
+                            indexVariableName, hasIndexVariable,
+                            ListBuiltins.ParallelEach);
+
+    auto items = list->clone();
+    runInChunks(items->view().size(), [&](size_t begin, size_t end) -> k_value {
+      const auto& elements = items->view();
+      for (auto i = begin; i < end; ++i) {
+        callListLambda(lambda, itemVariableName, clone_value(elements[i]),
+                       indexVariableName, static_cast<k_int>(i));
+      }
+      return {};
+    });
+
+    return static_cast<k_int>(0);
+  }
+
+  k_value interpretParallelMap(k_stream stream,
+                               std::shared_ptr<CallStackFrame> frame,
+                               const k_list& list) {
+    auto lambda = getListLambda(stream, frame, ListBuiltins.ParallelMap);
+
+    k_string itemVariableName, indexVariableName;
+    auto hasIndexVariable = false;
+    processLambdaParameters(stream, lambda.getParameters(), itemVariableName,
+                            indexVariableName, hasIndexVariable,
+                            ListBuiltins.ParallelMap);
+
+    auto items = list->clone();
+    auto chunks = runInChunks(
+        items->view().size(), [&](size_t begin, size_t end) -> k_value {
+          const auto& elements = items->view();
+          auto mapped = std::make_shared<List>();
+          auto& results = mapped->elements();
+          results.reserve(end - begin);
+
+          for (auto i = begin; i < end; ++i) {
+            results.emplace_back(clone_value(
+                callListLambda(lambda, itemVariableName,
+                               clone_value(elements[i]), indexVariableName,
+                               static_cast<k_int>(i))));
+          }
+          return mapped;
+        });
+
+    return joinChunks(chunks);
+  }
+
+  k_value interpretParallelSelect(k_stream stream,
+                                  std::shared_ptr<CallStackFrame> frame,
+                                  const k_list& list) {
+    auto lambda = getListLambda(stream, frame, ListBuiltins.ParallelSelect);
+
+    k_string itemVariableName, indexVariableName;
+    auto hasIndexVariable = false;
+    processLambdaParameters(stream, lambda.getParameters(), itemVariableName,
+                            indexVariableName, hasIndexVariable,
+                            ListBuiltins.ParallelSelect);
+
+    auto items = list->clone();
+    auto chunks = runInChunks(
+        items->view().size(), [&](size_t begin, size_t end) -> k_value {
+          const auto& elements = items->view();
+          auto filtered = std::make_shared<List>();
+          auto& results = filtered->elements();
+
+          for (auto i = begin; i < end; ++i) {
+            auto value =
+                callListLambda(lambda, itemVariableName, elements[i],
+                               indexVariableName, static_cast<k_int>(i));
+            if (std::holds_alternative<bool>(value) && std::get<bool>(value)) {
+              results.emplace_back(elements[i]);
+            }
+          }
+          return filtered;
+        });
+
+    return joinChunks(chunks);
+  }
+
+  /// @brief Reduces with an associative combiner. Each chunk is folded from
+  /// its first item, then the partial results are folded into the
+  /// accumulator in order.
+  k_value interpretParallelReduce(k_stream stream,
+                                  std::shared_ptr<CallStackFrame> frame,
+                                  const k_list& list) {
+    stream->next();  // Skip "("
+
+    auto accumulator = parseExpression(stream, frame);
+
+    if (stream->current().getType() == KTokenType::COMMA) {
+      stream->next();
+    }
+
+    auto lambda = getListLambda(stream, frame, ListBuiltins.ParallelReduce,
+                                false);
+
+    k_string accumulatorName, itemVariableName;
+    bool hasItemVariable = false;
+    processLambdaParameters(stream, lambda.getParameters(), accumulatorName,
+                            itemVariableName, hasItemVariable,
+                            ListBuiltins.ParallelReduce);
+    if (!hasItemVariable) {
+      throw InvalidOperationError(
+          stream->current(), "Expected two parameters in `" +
+                                 ListBuiltins.ParallelReduce + "` builtin.");
+    }
+
+    auto items = list->clone();
+    auto partials = runInChunks(
+        items->view().size(), [&](size_t begin, size_t end) -> k_value {
+          const auto& elements = items->view();
+          auto partial = clone_value(elements[begin]);
+          for (auto i = begin + 1; i < end; ++i) {
+            partial = clone_value(callListLambda(
+                lambda, accumulatorName, partial, itemVariableName,
+                clone_value(elements[i])));
+          }
+          return partial;
+        });
+
+    for (auto& partial : partials) {
+      accumulator =
+          clone_value(callListLambda(lambda, accumulatorName, accumulator,
+                                     itemVariableName, std::move(partial)));
+    }
+
+    return accumulator;
+  }
+
+  /// @brief Parses the lambda argument of a list builtin.
+  Method getListLambda(k_stream stream, std::shared_ptr<CallStackFrame> frame,
+                       const k_string& builtin, bool skipOpenParen = true) {
+    if (skipOpenParen) {
+      stream->next();  // Skip "("
+    }
+
+    auto lambda = getLambda(stream, frame);
+
+    if (stream->current().getType() == CLOSE_PAREN) {
+      stream->next();  // Skip ")"
+    }
+
+    if (!lambda.isFlagSet(MethodFlags::Lambda)) {
+      throw InvalidOperationError(
+          stream->current(),
+          "Expected a lambda in `" + builtin + "` builtin.");
+    }
+
+    return lambda;
+  }
+
+  /// @brief Calls a lambda of a list builtin on top of the current frame.
+  /// @param secondName The second parameter, or empty if it is unused.
+  k_value callListLambda(const Method& lambda, const k_string& firstName,
+                         k_value first, const k_string& secondName,
+                         k_value second) {
+    auto subframe = buildSubFrame(callStack().top(), true);
+    subframe->variables.setLayout(getLayout(lambda));
+    subframe->variables[firstName] = std::move(first);
+    if (!secondName.empty()) {
+      subframe->variables[secondName] = std::move(second);
+    }
+
+    callStack().push(subframe);
+    streamStack().push(compiledStream(lambda));
+    interpretStackFrame();
+
+    auto& top = callStack().top();
+    top->clearFlag(FrameFlags::ReturnFlag);
+    return std::move(top->returnValue);
+  }
+
+  /// @brief Splits `count` items into chunks and runs `body(begin, end)` on
+  /// the task pool for each. Every chunk runs in a context forked from this
+  /// one, so the lambdas see a copy of the variables in scope.
+  /// @return The result of each chunk, in order.
+  template <typename ChunkBody>
+  std::vector<k_value> runInChunks(size_t count, ChunkBody body) {
+    auto chunks = std::min(count, task.getWorkerCount() * ChunksPerWorker);
+
+    std::vector<k_int> ids;
+    for (size_t i = 0; i < chunks; ++i) {
+      auto begin = count * i / chunks, end = count * (i + 1) / chunks;
+      auto context = ExecutionContext::fork();
+      ids.push_back(task.addTask([context, &body, begin, end]() -> k_value {
+        ExecutionContext::Scope scope(*context);
+        // Errors fail the chunk and are raised again in the caller.
+        context->callStack.top()->clearFlag(FrameFlags::InTry);
+        return body(begin, end);
+      }));
+    }
+
+    try {
+      return std::move(*task.awaitAll(ids, std::nullopt));
+    } catch (const TaskCancelled&) {
+      // Chunks outlive their caller otherwise. Their errors go with it.
+      for (const auto& id : ids) {
+        task.cancel(id);
+      }
+      try {
+        task.awaitAll(ids, std::nullopt);
+      } catch (...) {
+      }
+      throw;
+    }
+  }
+
+  k_list joinChunks(const std::vector<k_value>& chunks) {
+    auto joined = std::make_shared<List>();
+    auto& elements = joined->elements();
+
+    for (const auto& chunk : chunks) {
+      const auto& items = std::get<k_list>(chunk)->view();
+      elements.insert(elements.end(), items.begin(), items.end());
+    }
+
+    return joined;
+  }
+
   void processLambdaParameters(k_stream stream,
                                const std::vector<k_string>& parameters,
                                k_string& firstVariableName,
@@ -3264,7 +4256,7 @@ class Interpreter {
     }
 
     auto hash = std::make_shared<Hash>();
-    auto clazz = classes[object->className];
+    const auto& clazz = getClass(object->className);
     for (const auto& pair : object->instanceVariables) {
       if (clazz.hasPrivateVariable(pair.first)) {
         continue;
@@ -3280,11 +4272,11 @@ class Interpreter {
                                       std::shared_ptr<CallStackFrame> frame,
                                       const KName& builtin,
                                       const k_value& value) {
-    if (!std::holds_alternative<k_string>(value)) {
+    if (!std::holds_alternative<k_text>(value)) {
       throw InvalidOperationError(stream->current(), "Expected type String.");
     }
 
-    auto input = std::get<k_string>(value);
+    auto input = std::get<k_text>(value).str();
 
     if (builtin == KName::Builtin_List_ToH) {
       return interpretStringToHash(stream, frame, input);
@@ -3331,6 +4323,18 @@ class Interpreter {
       case KName::Builtin_List_None:
         return interpretLambdaNone(stream, frame, list);
 
+      case KName::Builtin_List_ParallelEach:
+        return interpretParallelEach(stream, frame, list);
+
+      case KName::Builtin_List_ParallelMap:
+        return interpretParallelMap(stream, frame, list);
+
+      case KName::Builtin_List_ParallelReduce:
+        return interpretParallelReduce(stream, frame, list);
+
+      case KName::Builtin_List_ParallelSelect:
+        return interpretParallelSelect(stream, frame, list);
+
       case KName::Builtin_List_Sort:
         return interpretListSort(stream, list);
 
@@ -3357,6 +4361,7 @@ class Interpreter {
     }
 
     auto term = stream->current();
+    auto site = stream->position;
 
     auto callText = term.getText();
     auto call = term.getSubType();
@@ -3368,7 +4373,7 @@ class Interpreter {
 
     if (std::holds_alternative<k_object>(value)) {
       auto object = std::get<k_object>(value);
-      auto clazz = classes[object->className];
+      const auto& clazz = getClass(object->className);
       isObject = true;
 
       if (object->hasVariable(callText)) {
@@ -3427,7 +4432,8 @@ class Interpreter {
 
     if (std::holds_alternative<k_object>(value)) {
       return interpretInstanceMethodInvocation(
-          stream, frame, std::get<k_object>(value), callText, call, args);
+          stream, frame, std::get<k_object>(value), callText, call, args,
+          site);
     }
 
     return BuiltinDispatch::execute(term, call, value, args);
@@ -3449,8 +4455,225 @@ class Interpreter {
     return false;
   }
 
+  k_stream compiledStream(k_tokens code,
+                          const std::shared_ptr<ExpressionCache>& expressions) {
+    auto stream = std::make_shared<TokenStream>(std::move(code));
+    expressions->reserve(stream->tokens, {});
+    stream->expressions = expressions;
+    return stream;
+  }
+
+  k_stream compiledStream(const Method& method) {
+    getLayout(method);
+    return compiledStream(method.getTokens(), method.getExpressions());
+  }
+
+  /// @brief The frame layout of a method body, resolved on first use.
+  const std::shared_ptr<const FrameLayout>& getLayout(const Method& method) {
+    const auto& expressions = method.getExpressions();
+    expressions->reserve(*method.getTokens(), method.getParameters());
+    return expressions->getLayout();
+  }
+
+  bool parseCompiledExpression(k_stream stream,
+                               std::shared_ptr<CallStackFrame> frame,
+                               k_value& result) {
+    const auto& expressions = stream->expressions;
+    if (!expressions) {
+      return false;
+    }
+
+    auto position = stream->position;
+    auto compiled = expressions->get(position);
+    if (!compiled) {
+      auto entry = ExpressionCompiler::compile(
+          stream->tokens, position, expressions->getLayout().get());
+      if (vmEnabled && entry->root) {
+        entry->chunk = BytecodeCompiler::compile(*entry->root);
+      }
+      compiled = expressions->put(position, std::move(entry));
+    }
+
+    if (!compiled || !compiled->root) {
+      return false;
+    }
+
+    if (!compiled->chunk) {
+      if (!evaluateCompiled(*compiled->root, frame, result)) {
+        return false;
+      }
+    } else if (!VirtualMachine::execute(*compiled->chunk, frame, result)) {
+      return false;
+    } else if (vmVerify) {
+      auto expected = parseTokenExpression(stream, frame);
+      if (stream->position != compiled->end ||
+          !(same_value(result, expected) ||
+            Serializer::serialize(result) == Serializer::serialize(expected))) {
+        throw VirtualMachineError(
+            stream->tokens.at(position),
+            "The VM evaluated `" + Serializer::serialize(result) +
+                "` but the interpreter evaluated `" +
+                Serializer::serialize(expected) + "`.");
+      }
+    }
+
+    stream->position = compiled->end;
+    return true;
+  }
+
+  bool evaluateCompiled(const AstNode& node,
+                        const std::shared_ptr<CallStackFrame>& frame,
+                        k_value& result) {
+    switch (node.kind) {
+      case AstKind::Literal:
+        result = node.value;
+        return true;
+
+      case AstKind::Variable: {
+        auto variable = InterpHelper::findVariable(frame, node.variable);
+        // Lambdas and methods are invoked by the interpreter.
+        if (!variable || std::holds_alternative<k_lambda>(*variable)) {
+          return false;
+        }
+        result = *variable;
+        return true;
+      }
+
+      case AstKind::Unary: {
+        k_value right;
+        if (!evaluateCompiled(*node.right, frame, right)) {
+          return false;
+        }
+
+        switch (node.op) {
+          case KName::Ops_Not:
+            result = NegateVisitor(node.token)(right);
+            break;
+
+          case KName::Ops_Subtract:
+            result = NegateSignVisitor(node.token)(right);
+            break;
+
+          case KName::Ops_BitwiseNot:
+            result = BitwiseNotVisitor(node.token)(right);
+            break;
+
+          default:
+            return false;
+        }
+        return true;
+      }
+
+      case AstKind::Ternary: {
+        k_value condition, trueBranch, falseBranch;
+        if (!evaluateCompiled(*node.condition, frame, condition) ||
+            !evaluateCompiled(*node.left, frame, trueBranch) ||
+            !evaluateCompiled(*node.right, frame, falseBranch)) {
+          return false;
+        }
+
+        if (!std::holds_alternative<bool>(condition)) {
+          throw ConversionError(
+              node.token, "Ternary condition must be a boolean expression.");
+        }
+
+        result = std::get<bool>(condition) ? trueBranch : falseBranch;
+        return true;
+      }
+
+      default:
+        break;
+    }
+
+    k_value left, right;
+    if (!evaluateCompiled(*node.left, frame, left) ||
+        !evaluateCompiled(*node.right, frame, right)) {
+      return false;
+    }
+
+    if (node.kind == AstKind::LogicalOr || node.kind == AstKind::LogicalAnd) {
+      if (!(std::holds_alternative<bool>(left) &&
+            std::holds_alternative<bool>(right))) {
+        throw ConversionError(node.token, "Expected a `Boolean` expression.");
+      }
+
+      bool lhs = std::get<bool>(left), rhs = std::get<bool>(right);
+      result = node.kind == AstKind::LogicalOr ? lhs || rhs : lhs && rhs;
+      return true;
+    }
+
+    const auto& token = node.token;
+    switch (node.op) {
+      case KName::Ops_Add:
+        result = AddVisitor(token)(left, right);
+        break;
+      case KName::Ops_Subtract:
+        result = SubtractVisitor(token)(left, right);
+        break;
+      case KName::Ops_Multiply:
+        result = MultiplyVisitor(token)(left, right);
+        break;
+      case KName::Ops_Divide:
+        result = DivideVisitor(token)(left, right);
+        break;
+      case KName::Ops_Modulus:
+        result = ModuloVisitor(token)(left, right);
+        break;
+      case KName::Ops_Exponent:
+        result = PowerVisitor(token)(left, right);
+        break;
+      case KName::Ops_Equal:
+        result = EqualityVisitor()(left, right);
+        break;
+      case KName::Ops_NotEqual:
+        result = InequalityVisitor()(left, right);
+        break;
+      case KName::Ops_LessThan:
+        result = LessThanVisitor()(left, right);
+        break;
+      case KName::Ops_LessThanOrEqual:
+        result = LessThanOrEqualVisitor()(left, right);
+        break;
+      case KName::Ops_GreaterThan:
+        result = GreaterThanVisitor()(left, right);
+        break;
+      case KName::Ops_GreaterThanOrEqual:
+        result = GreaterThanOrEqualVisitor()(left, right);
+        break;
+      case KName::Ops_BitwiseAnd:
+        result = BitwiseAndVisitor(token)(left, right);
+        break;
+      case KName::Ops_BitwiseOr:
+        result = BitwiseOrVisitor(token)(left, right);
+        break;
+      case KName::Ops_BitwiseXor:
+        result = BitwiseXorVisitor(token)(left, right);
+        break;
+      case KName::Ops_BitwiseLeftShift:
+        result = BitwiseLeftShiftVisitor(token)(left, right);
+        break;
+      case KName::Ops_BitwiseRightShift:
+        result = BitwiseRightShiftVisitor(token)(left, right);
+        break;
+      default:
+        return false;
+    }
+
+    return true;
+  }
+
   k_value parseExpression(k_stream stream,
                           std::shared_ptr<CallStackFrame> frame) {
+    k_value compiled;
+    if (parseCompiledExpression(stream, frame, compiled)) {
+      return compiled;
+    }
+
+    return parseTokenExpression(stream, frame);
+  }
+
+  k_value parseTokenExpression(k_stream stream,
+                               std::shared_ptr<CallStackFrame> frame) {
     k_value value = parseLogicalOr(stream, frame);
 
     if (stream->current().getType() == KTokenType::QUESTION) {
@@ -3785,7 +5008,7 @@ class Interpreter {
           return interpretSelfInvocationTerm(stream, frame);
         } else if (current.getSubType() == KName::KW_Lambda) {
           return interpretLambdaExpression(stream, frame);
-        } else if (std::holds_alternative<k_string>(value)) {
+        } else if (std::holds_alternative<k_text>(value)) {
           if (current.getSubType() == KName::Regex) {
             stream->next();
             return value;
@@ -3814,17 +5037,18 @@ class Interpreter {
     }
 
     auto identifier = stream->current().getText();
+    auto site = stream->position;
     stream->next();  // Skip the identifier
 
     auto objContext = frame->getObjectContext();
-    auto clazz = classes[objContext->className];
+    const auto& clazz = getClass(objContext->className);
 
     if (clazz.hasMethod(identifier)) {
       interpretInstanceMethodInvocation(stream, frame, objContext->identifier,
-                                        identifier);
+                                        identifier, site);
 
-      if (!callStack.empty()) {
-        return callStack.top()->returnValue;
+      if (!callStack().empty()) {
+        return callStack().top()->returnValue;
       }
     } else if (objContext->hasVariable(identifier)) {
       return objContext->instanceVariables[identifier];
@@ -3845,7 +5069,7 @@ class Interpreter {
                              std::shared_ptr<CallStackFrame> frame,
                              k_value& value) {
     auto object = std::get<k_object>(value);
-    auto clazz = classes[object->className];
+    const auto& clazz = getClass(object->className);
 
     if (!clazz.hasMethod(KiwiBuiltins.ToS)) {
       return Serializer::basic_serialize_object(object);
@@ -3868,75 +5092,41 @@ class Interpreter {
     return parseExpression(tempStream, tempFrame);
   }
 
-  k_string interpolateString(k_stream stream,
-                             std::shared_ptr<CallStackFrame> frame) {
-    auto input = stream->current().getText();
-    std::ostringstream sv;
+  k_value interpolateString(k_stream stream,
+                            std::shared_ptr<CallStackFrame> frame) {
+    const auto& token = stream->current();
+    auto compiled = token.getTemplate();
+    if (!compiled) {
+      compiled = Lexer::compileTemplate(token.getText());
+    }
 
-    for (size_t i = 0; i < input.length(); ++i) {
-      char c = input[i];
+    if (compiled->malformed) {
+      throw SyntaxError(token, "Unmatched braces in string interpolation: `" +
+                                   token.getText() + "`");
+    }
 
-      if (c == '$' && i + 1 < input.length() && input[i + 1] == '{') {
-        i += 2;  // Skip "${"
-        size_t start = i;
-        int braceCount = 1;
-        while (i < input.length() && braceCount > 0) {
-          if (input[i] == '{') {
-            ++braceCount;
-          } else if (input[i] == '}') {
-            --braceCount;
-          }
-          ++i;
-        }
+    if (compiled->segments.empty()) {
+      return compiled->text;
+    }
 
-        if (braceCount != 0) {
-          throw SyntaxError(
-              stream->current(),
-              "Unmatched braces in string interpolation: `" + input + "`");
-        }
-        
-        --i;  // Go back to the closing brace
-        auto value = interpolateString(frame, input.substr(start, i - start));
-        if (!std::holds_alternative<k_object>(value)) {
-          sv << Serializer::serialize(value);
-        } else {
-          sv << interpolateObject(stream, frame, value);
-        }
-      } else if (c == '\\') {
-        // Handle escape sequences
-        if (i + 1 < input.length()) {
-          switch (input[i + 1]) {
-            case 't':
-              sv << '\t';
-              break;
-            case 'n':
-              sv << '\n';
-              break;
-            case 'r':
-              sv << '\r';
-              break;
-            case 'b':
-              sv << '\b';
-              break;
-            case 'f':
-              sv << '\f';
-              break;
-            case '\\':
-              sv << '\\';
-              break;
-
-            default:
-              sv << input[i + 1];
-              break;
-          }
-          i++;
-        }
+    k_string output;
+    output.reserve(compiled->literalLength + 16 * compiled->segments.size());
+    auto tempFrame = buildSubFrame(frame);
+
+    for (const auto& segment : compiled->segments) {
+      output += segment.literal;
+
+      auto value = parseExpression(
+          compiledStream(segment.expression, segment.expressions), tempFrame);
+      if (!std::holds_alternative<k_object>(value)) {
+        output += Serializer::serialize(value);
       } else {
-        sv << c;
+        output += interpolateObject(stream, frame, value);
       }
     }
 
-    return sv.str();
+    output += compiled->trailing;
+    return output;
   }
 
   void interpretLambdaAssignment(k_stream stream,
@@ -3964,7 +5154,7 @@ class Interpreter {
 
     auto keyValue = parseExpression(stream, frame);
 
-    if (!std::holds_alternative<k_string>(keyValue)) {
+    if (!std::holds_alternative<k_text>(keyValue)) {
       throw SyntaxError(stream->current(), "Hash key must be a string value.");
     }
 
@@ -3981,11 +5171,40 @@ class Interpreter {
 
     auto elementValue = parseExpression(stream, frame);
     auto hashValue = std::get<k_hash>(value);
-    hashValue->add(std::get<k_string>(keyValue), elementValue);
+    hashValue->add(std::get<k_text>(keyValue).str(), elementValue);
 
     frame->variables[name] = hashValue;
   }
 
+  void interpretBytesElementAssignment(k_stream stream,
+                                       std::shared_ptr<CallStackFrame> frame,
+                                       k_value& value) {
+    k_int index = interpretIndex(stream, frame);
+
+    if (!stream->matchsub(KName::Ops_Assign)) {
+      throw InvalidOperationError(stream->current(),
+                                  "Expected assignment operator.");
+    }
+
+    auto elementValue = parseExpression(stream, frame);
+    if (!std::holds_alternative<k_int>(elementValue)) {
+      throw ConversionError(stream->current(), "Expected an Integer value.");
+    }
+
+    auto bytes = std::get<k_bytes>(value);
+    auto size = static_cast<k_int>(bytes->size());
+    if (index < 0) {
+      index += size;
+    }
+
+    if (index < 0 || index >= size) {
+      throw RangeError(stream->current(), "Bytes index out of range.");
+    }
+
+    bytes->set(static_cast<size_t>(index),
+               static_cast<uint8_t>(std::get<k_int>(elementValue) & 0xFF));
+  }
+
   void interpretSliceAssignment(k_stream stream,
                                 std::shared_ptr<CallStackFrame> frame,
                                 const k_string& name) {
@@ -3996,6 +5215,11 @@ class Interpreter {
       return;
     }
 
+    if (std::holds_alternative<k_bytes>(value)) {
+      interpretBytesElementAssignment(stream, frame, value);
+      return;
+    }
+
     if (!std::holds_alternative<k_list>(value)) {
       throw InvalidOperationError(stream->current(),
                                   "`" + name + "` is not a list.");
@@ -4042,6 +5266,10 @@ class Interpreter {
       name = stream->current().getText();
     }
 
+    auto symbol = stream->current().getText() == name
+                      ? stream->current().getSymbol()
+                      : SymbolTable::None;
+
     if (!isInstanceVariable) {
       stream->next();  // Skip the identifier.
     }
@@ -4053,7 +5281,8 @@ class Interpreter {
 
         if (Operators.is_assignment_operator(op) ||
             op == KName::Ops_BitwiseLeftShift) {
-          interpretAssignment(stream, name, op, frame, isInstanceVariable);
+          interpretAssignment(stream, name, op, frame, isInstanceVariable,
+                              symbol);
         }
       } break;
 
@@ -4095,7 +5324,8 @@ class Interpreter {
   void interpretAssignment(k_stream stream, const k_string& name,
                            const KName& op,
                            std::shared_ptr<CallStackFrame> frame,
-                           bool isInstanceVariable = false) {
+                           bool isInstanceVariable = false,
+                           k_symbol symbol = SymbolTable::None) {
     k_value value;
 
     switch (stream->current().getType()) {
@@ -4125,7 +5355,7 @@ class Interpreter {
           object->identifier = name;
           value = object;
         }
-        frame->variables[name] = value;
+        frame->variables.at(symbol, name) = value;
       }
 
       switch (stream->peek().getType()) {
@@ -4141,7 +5371,8 @@ class Interpreter {
       return;
     }
 
-    if (!InterpHelper::hasVariable(frame, name)) {
+    auto variable = InterpHelper::findVariable(frame, symbol, name);
+    if (!variable) {
       throw VariableUndefinedError(stream->current(), name);
     }
 
@@ -4150,14 +5381,14 @@ class Interpreter {
       return;
     }
 
-    auto currentValue = InterpHelper::getVariable(stream, frame, name);
+    auto currentValue = *variable;
     auto newValue =
         InterpHelper::interpretAssignOp(stream, op, currentValue, value);
 
     if (isInstanceVariable && frame->inObjectContext()) {
       frame->getObjectContext()->instanceVariables[name] = newValue;
     } else {
-      frame->variables[name] = newValue;
+      frame->variables.at(symbol, name) = newValue;
     }
   }
 };
@@ -135,14 +135,14 @@ struct InterpHelper {
   }
 
   static void updateVariablesInCallerFrame(
-      const std::unordered_map<k_string, k_value>& variables,
+      const FrameVariables& variables,
       std::shared_ptr<CallStackFrame> callerFrame) {
     auto& frameVariables = callerFrame->variables;
-    for (const auto& var : variables) {
-      if (shouldUpdateFrameVariables(var.first, callerFrame)) {
-        frameVariables[var.first] = var.second;
+    variables.forEach([&](const k_string& name, const k_value& value) {
+      if (shouldUpdateFrameVariables(name, callerFrame)) {
+        frameVariables[name] = value;
       }
-    }
+    });
   }
 
   static k_string getTemporaryId() {
@@ -257,8 +257,8 @@ struct InterpHelper {
       stop = start;
     }
 
-    auto& elements = targetList->elements;
-    auto& rhsElements = rhsValues->elements;
+    auto& elements = targetList->elements();
+    auto& rhsElements = rhsValues->elements();
 
     // Convert negative indices and adjust ranges
     int listSize = static_cast<int>(elements.size());
@@ -352,10 +352,10 @@ struct InterpHelper {
 
   static k_value stringSlice(k_stream stream, SliceIndex& slice,
                              const k_value& value) {
-    auto string = std::get<k_string>(value);
+    auto string = std::get<k_text>(value).str();
     auto list = std::make_shared<List>();
 
-    auto& elements = list->elements;
+    auto& elements = list->elements();
     for (const char& c : string) {
       elements.emplace_back(k_string(1, c));
     }
@@ -364,7 +364,7 @@ struct InterpHelper {
     std::ostringstream sv;
 
     if (std::holds_alternative<k_list>(sliced)) {
-      auto slicedlist = std::get<k_list>(sliced)->elements;
+      auto slicedlist = std::get<k_list>(sliced)->elements();
       for (auto it = slicedlist.begin(); it != slicedlist.end(); ++it) {
         sv << Serializer::serialize(*it);
       }
@@ -375,10 +375,91 @@ struct InterpHelper {
     return sv.str();
   }
 
+  // A slice with a step of 1 is a view that shares the bytes it was cut from.
+  static k_value bytesSlice(k_stream stream, const SliceIndex& slice,
+                            const k_value& value) {
+    const auto& bytes = std::get<k_bytes>(value);
+    auto size = static_cast<k_int>(bytes->size());
+
+    if (!slice.isSlice) {
+      if (!std::holds_alternative<k_int>(slice.indexOrStart)) {
+        throw IndexError(stream->current(), "Index value must be an integer.");
+      }
+
+      auto index = std::get<k_int>(slice.indexOrStart);
+      if (index < 0) {
+        index += size;
+      }
+
+      if (index < 0 || index >= size) {
+        throw RangeError(stream->current(), "Bytes index out of range.");
+      }
+
+      return static_cast<k_int>(bytes->data()[index]);
+    }
+
+    if (!std::holds_alternative<k_int>(slice.indexOrStart)) {
+      throw IndexError(stream->current(), "Start index must be an integer.");
+    } else if (!std::holds_alternative<k_int>(slice.stopIndex)) {
+      throw IndexError(stream->current(), "Stop index must be an integer.");
+    } else if (!std::holds_alternative<k_int>(slice.stepValue)) {
+      throw IndexError(stream->current(), "Step value must be an integer.");
+    }
+
+    auto start = std::get<k_int>(slice.indexOrStart),
+         stop = std::get<k_int>(slice.stopIndex),
+         step = std::get<k_int>(slice.stepValue);
+
+    if (step == 0) {
+      throw IndexError(stream->current(), "Step value must not be zero.");
+    }
+
+    // Adjust negative indices
+    if (start < 0) {
+      start = start + size > 0 ? start + size : 0;
+    }
+
+    if (stop < 0) {
+      stop += size;
+    } else {
+      stop = stop < size ? stop : size;
+    }
+
+    if (step == 1) {
+      start = std::min(start, size);
+      auto count = stop > start ? stop - start : 0;
+      return bytes->slice(static_cast<size_t>(start),
+                          static_cast<size_t>(count));
+    }
+
+    // Adjust stop for reverse slicing
+    if (step < 0 && stop == size) {
+      stop = -1;
+    }
+
+    std::vector<uint8_t> sliced;
+    if (step < 0) {
+      for (auto i = (start == 0 ? size - 1 : start); i >= stop; i += step) {
+        // Prevent out-of-bounds access
+        if (i < 0 || i >= size) {
+          break;
+        }
+
+        sliced.push_back(bytes->data()[i]);
+      }
+    } else {
+      for (auto i = start; i < stop; i += step) {
+        sliced.push_back(bytes->data()[i]);
+      }
+    }
+
+    return std::make_shared<Bytes>(std::move(sliced));
+  }
+
   static k_value listSlice(k_stream stream, const SliceIndex& slice,
                            const k_value& value) {
     auto list = std::get<k_list>(value);
-    auto& elements = list->elements;
+    auto& elements = list->elements();
     if (slice.isSlice) {
       if (!std::holds_alternative<k_int>(slice.indexOrStart)) {
         throw IndexError(stream->current(), "Start index must be an integer.");
@@ -410,7 +491,7 @@ struct InterpHelper {
       }
 
       auto slicedList = std::make_shared<List>();
-      auto& slicedElements = slicedList->elements;
+      auto& slicedElements = slicedList->elements();
 
       if (step < 0) {
         for (int i = (start == 0 ? listSize - 1 : start); i >= stop;
@@ -467,40 +548,80 @@ struct InterpHelper {
     }
 
     // Check in outer frames
-    std::stack<std::shared_ptr<CallStackFrame>> tempStack(
-        callStack);  // Copy the call stack
-    while (!tempStack.empty()) {
-      const auto& outerFrame = tempStack.top();
+    for (const auto& outerFrame : ExecutionContext::current().callStack) {
       if (outerFrame->hasVariable(name)) {
         return true;  // Found in an outer frame
       }
-      tempStack.pop();
     }
 
     return false;  // Not found in any scope
   }
 
-  static k_value getVariable(k_stream stream,
-                             std::shared_ptr<CallStackFrame> frame,
-                             const k_string& name) {
-    // Check in the current frame
-    if (frame->hasVariable(name)) {
-      return frame->variables[name];
+  static k_value* findVariable(const std::shared_ptr<CallStackFrame>& frame,
+                               const k_string& name) {
+    return findVariable(frame, SymbolTable::None, name);
+  }
+
+  static k_value* findVariable(const std::shared_ptr<CallStackFrame>& frame,
+                               k_symbol symbol, const k_string& name) {
+    if (auto variable = frame->findVariable(symbol, name)) {
+      return variable;
     }
 
-    if (frame->inObjectContext() &&
-        frame->getObjectContext()->hasVariable(name)) {
-      return frame->getObjectContext()->instanceVariables[name];
+    if (frame->inObjectContext()) {
+      auto& instanceVariables = frame->getObjectContext()->instanceVariables;
+      auto ivar = instanceVariables.find(name);
+      if (ivar != instanceVariables.end()) {
+        return &ivar->second;
+      }
     }
 
     // Check in outer frames
-    auto tempStack(callStack);
-    while (!tempStack.empty()) {
-      const auto& outerFrame = tempStack.top();
-      if (outerFrame->hasVariable(name)) {
-        return outerFrame->variables[name];
+    for (const auto& outerFrame : ExecutionContext::current().callStack) {
+      if (auto variable = outerFrame->findVariable(symbol, name)) {
+        return variable;
+      }
+    }
+
+    return nullptr;
+  }
+
+  /// @brief Finds a variable resolved at compile time. Reads the slot directly
+  /// when the frames are laid out as the compiler saw them, and falls back to
+  /// a lookup by name otherwise.
+  static k_value* findVariable(const std::shared_ptr<CallStackFrame>& frame,
+                               const VariableRef& ref) {
+    auto scope = frame.get();
+    if (ref.layout && scope->variables.getLayout() == ref.layout) {
+      for (size_t hop = 0; hop < ref.hops && scope; ++hop) {
+        // The name has no slot here, so it can only be shadowed by name.
+        if (scope->variables.hasNamed() || scope->scopeObject) {
+          scope = nullptr;
+          break;
+        }
+
+        auto expected = scope->variables.getLayout()->getParent();
+        scope = scope->parent.get();
+        if (scope && scope->variables.getLayout() != expected) {
+          scope = nullptr;
+        }
+      }
+
+      if (scope) {
+        if (auto variable = scope->variables.atSlot(ref.slot)) {
+          return variable;
+        }
       }
-      tempStack.pop();
+    }
+
+    return findVariable(frame, ref.symbol, ref.name);
+  }
+
+  static k_value getVariable(k_stream stream,
+                             std::shared_ptr<CallStackFrame> frame,
+                             const k_string& name) {
+    if (auto variable = findVariable(frame, name)) {
+      return *variable;
     }
 
     throw VariableUndefinedError(stream->current(), name);
@@ -530,13 +651,23 @@ struct InterpHelper {
       throw VariableUndefinedError(stream->current(), listVariableName);
     }
 
+    if (std::holds_alternative<k_bytes>(variableValue)) {
+      if (!std::holds_alternative<k_int>(listValue)) {
+        throw ConversionError(stream->current(), "Expected an Integer value.");
+      }
+
+      auto byte = std::get<k_int>(listValue) & 0xFF;
+      std::get<k_bytes>(variableValue)->push(static_cast<uint8_t>(byte));
+      return;
+    }
+
     if (!std::holds_alternative<k_list>(variableValue)) {
       throw InvalidOperationError(stream->current(),
                                   "`" + listVariableName + "` is not a list.");
     }
 
     const auto& listPtr = std::get<k_list>(variableValue);
-    listPtr->elements.emplace_back(listValue);
+    listPtr->elements().emplace_back(listValue);
   }
 
   static void interpretParameterizedCatch(k_stream stream,
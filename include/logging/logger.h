@@ -1,10 +1,19 @@
 #ifndef KIWI_LOGGING_LOGGER_H
 #define KIWI_LOGGING_LOGGER_H
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <ctime>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <thread>
+#include <vector>
 #include "tracing/error.h"
 #include "util/file.h"
 #include "util/time.h"
@@ -12,6 +21,83 @@
 enum class LogLevel { DEBUG, INFO, WARNING, ERROR_, SILENT };
 enum class LogMode { CONSOLE, FILE };
 
+// A formatted entry and where it goes. A null file means the console.
+struct LogRecord {
+  std::string text;
+  std::shared_ptr<std::ofstream> file;
+};
+
+// A bounded multi-producer, single-consumer queue of log records. Each cell
+// carries a sequence number that tells producers and the consumer whose turn
+// it is, as in `Channel`, so neither side ever locks.
+class LogQueue {
+ public:
+  explicit LogQueue(size_t capacity)
+      : capacity(capacity), cells(new Cell[capacity]) {
+    for (size_t i = 0; i < capacity; ++i) {
+      cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  LogQueue(const LogQueue&) = delete;
+  LogQueue& operator=(const LogQueue&) = delete;
+
+  /// @brief Queues a record unless the queue is full. The record is only
+  /// moved from on success.
+  bool tryPush(LogRecord& record) {
+    auto position = pushPosition.load(std::memory_order_relaxed);
+    while (true) {
+      auto& cell = cells[position % capacity];
+      auto sequence = cell.sequence.load(std::memory_order_acquire);
+      auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+
+      if (difference == 0) {
+        if (pushPosition.compare_exchange_weak(position, position + 1,
+                                               std::memory_order_relaxed)) {
+          cell.record = std::move(record);
+          cell.sequence.store(position + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (difference < 0) {
+        return false;  // Full.
+      } else {
+        position = pushPosition.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /// @brief Takes the oldest record, if there is one. Only the consumer may
+  /// call this.
+  bool tryPop(LogRecord& record) {
+    auto& cell = cells[popPosition % capacity];
+    if (cell.sequence.load(std::memory_order_acquire) != popPosition + 1) {
+      return false;  // Empty.
+    }
+
+    record = std::move(cell.record);
+    cell.record = {};
+    cell.sequence.store(popPosition + capacity, std::memory_order_release);
+    ++popPosition;
+    return true;
+  }
+
+  bool empty() const {
+    auto& cell = cells[popPosition % capacity];
+    return cell.sequence.load(std::memory_order_acquire) != popPosition + 1;
+  }
+
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    LogRecord record;
+  };
+
+  const size_t capacity;
+  std::unique_ptr<Cell[]> cells;
+  alignas(64) std::atomic<size_t> pushPosition{0};
+  alignas(64) size_t popPosition = 0;
+};
+
 class Logger {
  public:
   Logger(const Logger&) = delete;
@@ -42,6 +128,14 @@ class Logger {
       return LogMode::CONSOLE;
   }
 
+  ~Logger() {
+    stopping.store(true, std::memory_order_release);
+    wake();
+    if (writer.joinable()) {
+      writer.join();
+    }
+  }
+
   void error(const std::string& message, const std::string& source = "") const {
     log(LogLevel::ERROR_, message, source);
   }
@@ -59,81 +153,246 @@ class Logger {
   }
 
   void setMinimumLogLevel(LogLevel level) {
-    std::lock_guard<std::mutex> lock(logMutex);
+    std::unique_lock<std::shared_mutex> lock(logMutex);
     minLogLevel = level;
   }
 
   void setLogMode(LogMode mode) {
-    std::lock_guard<std::mutex> lock(logMutex);
+    std::unique_lock<std::shared_mutex> lock(logMutex);
     logMode = mode;
   }
 
   void setTimestampFormat(const std::string& format) {
-    std::lock_guard<std::mutex> lock(logMutex);
+    std::unique_lock<std::shared_mutex> lock(logMutex);
     timestampFormat = format;
   }
 
   void setEntryFormat(const std::string& format) {
-    std::lock_guard<std::mutex> lock(logMutex);
-    entryFormat = format;
+    std::unique_lock<std::shared_mutex> lock(logMutex);
+    entryFormat = compileFormat(format);
   }
 
-  void setLogFilePath(const std::string& filePath) {
-    std::lock_guard<std::mutex> lock(logMutex);
-    logFilePath = filePath;
-    setLogMode(LogMode::FILE);
+  /// @brief Opens a file to append entries to, and switches to file mode.
+  /// Entries already queued still go where they were headed.
+  /// @return False if the file could not be opened.
+  bool setLogFilePath(const std::string& filePath) {
+    auto file = std::make_shared<std::ofstream>(filePath, std::ios::app);
+    if (!file->is_open()) {
+      return false;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(logMutex);
+    logFile = std::move(file);
+    logMode = LogMode::FILE;
+    return true;
   }
 
  private:
+  // A piece of the entry format: literal text, or a field filled in per entry.
+  struct Segment {
+    enum class Field { Text, Timestamp, Level, Source, Message };
+
+    Field field;
+    std::string text;
+  };
+
+  static constexpr size_t QueueCapacity = 8192;
+
   LogLevel minLogLevel;
   LogMode logMode;
-  std::string logFilePath;
+  std::shared_ptr<std::ofstream> logFile;
   std::string timestampFormat = "%Y-%m-%d %H:%M:%S";
-  std::string entryFormat = "[%timestamp][%level][%source] %message";
-  mutable std::mutex logMutex;
+  std::vector<Segment> entryFormat =
+      compileFormat("[%timestamp][%level][%source] %message");
+  mutable std::shared_mutex logMutex;
+
+  mutable LogQueue queue{QueueCapacity};
+  mutable std::mutex wakeMutex;
+  mutable std::condition_variable wakeup;
+  mutable std::atomic<bool> idle{false};
+  std::atomic<bool> stopping{false};
+  std::thread writer;
 
   Logger(LogLevel minLogLevel = LogLevel::INFO,
          LogMode logMode = LogMode::CONSOLE)
-      : minLogLevel(minLogLevel), logMode(logMode) {}
+      : minLogLevel(minLogLevel), logMode(logMode) {
+    writer = std::thread([this]() { writeEntries(); });
+  }
 
-  // TODO: it would be great to have a descriptor to describe log
-  // output/formatting
   void log(const LogLevel& level, const std::string& message,
            const std::string& source) const {
-    std::lock_guard<std::mutex> lock(logMutex);
+    LogRecord record;
+    {
+      std::shared_lock<std::shared_mutex> lock(logMutex);
+      if (level < minLogLevel) {
+        return;
+      }
 
-    if (level < minLogLevel) {
-      return;
+      if (logMode == LogMode::FILE) {
+        if (!logFile) {
+          return;
+        }
+        record.file = logFile;
+      }
+
+      record.text = getLogEntry(level, message, source);
     }
 
-    auto logEntry = getLogEntry(level, message, source);
+    while (!queue.tryPush(record)) {
+      // Full, so let the writer catch up.
+      wake();
+      std::this_thread::yield();
+    }
 
-    switch (logMode) {
-      case LogMode::CONSOLE:
-        std::cout << logEntry << std::endl;
-        break;
-      case LogMode::FILE:
-        if (!logFilePath.empty()) {
-          File::writeToFile(logFilePath, logEntry, true, false);
+    if (idle.load(std::memory_order_acquire)) {
+      wake();
+    }
+  }
+
+  void wake() const {
+    std::lock_guard<std::mutex> lock(wakeMutex);
+    wakeup.notify_one();
+  }
+
+  // Runs on the writer thread. Consecutive entries for the same destination
+  // are written and flushed together. A wake-up missed between the check and
+  // the wait costs no more than the poll interval.
+  void writeEntries() {
+    std::string batch;
+    std::shared_ptr<std::ofstream> batchFile;
+    LogRecord record;
+
+    while (true) {
+      bool wrote = false;
+      while (queue.tryPop(record)) {
+        if (!batch.empty() && record.file != batchFile) {
+          writeBatch(batch, batchFile);
         }
+
+        batchFile = std::move(record.file);
+        batch += record.text;
+        batch += '\n';
+        wrote = true;
+      }
+
+      if (!batch.empty()) {
+        writeBatch(batch, batchFile);
+        batchFile.reset();  // Let a file that is no longer in use close.
+      }
+
+      if (wrote) {
+        continue;
+      }
+
+      if (stopping.load(std::memory_order_acquire)) {
         break;
+      }
+
+      std::unique_lock<std::mutex> lock(wakeMutex);
+      idle.store(true, std::memory_order_release);
+      wakeup.wait_for(lock, std::chrono::milliseconds(10), [this]() {
+        return !queue.empty() || stopping.load(std::memory_order_acquire);
+      });
+      idle.store(false, std::memory_order_release);
+    }
+  }
+
+  static void writeBatch(std::string& batch,
+                         const std::shared_ptr<std::ofstream>& file) {
+    if (file) {
+      file->write(batch.data(), static_cast<std::streamsize>(batch.size()));
+      file->flush();
+    } else {
+      std::cout.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+      std::cout.flush();
+    }
+    batch.clear();
+  }
+
+  static std::vector<Segment> compileFormat(const std::string& format) {
+    static const std::vector<std::pair<std::string, Segment::Field>> fields = {
+        {"%timestamp", Segment::Field::Timestamp},
+        {"%level", Segment::Field::Level},
+        {"%source", Segment::Field::Source},
+        {"%message", Segment::Field::Message}};
+
+    std::vector<Segment> segments;
+    std::string text;
+    size_t position = 0;
+
+    while (position < format.size()) {
+      bool matched = false;
+      if (format[position] == '%') {
+        for (const auto& field : fields) {
+          if (format.compare(position, field.first.size(), field.first) == 0) {
+            if (!text.empty()) {
+              segments.push_back({Segment::Field::Text, std::move(text)});
+              text.clear();
+            }
+            segments.push_back({field.second, ""});
+            position += field.first.size();
+            matched = true;
+            break;
+          }
+        }
+      }
+
+      if (!matched) {
+        text += format[position++];
+      }
     }
+
+    if (!text.empty()) {
+      segments.push_back({Segment::Field::Text, std::move(text)});
+    }
+
+    return segments;
   }
 
   std::string getLogEntry(const LogLevel& level, const std::string& message,
                           const std::string& source) const {
-    auto timestamp = Time::getTimestamp(timestampFormat);
-    auto format = entryFormat;
+    std::string entry;
+    for (const auto& segment : entryFormat) {
+      switch (segment.field) {
+        case Segment::Field::Text:
+          entry += segment.text;
+          break;
+        case Segment::Field::Timestamp:
+          entry += getTimestamp();
+          break;
+        case Segment::Field::Level:
+          entry += logLevelToString(level);
+          break;
+        case Segment::Field::Source:
+          entry += source;
+          break;
+        case Segment::Field::Message:
+          entry += message;
+          break;
+      }
+    }
 
-    format = String::replace(format, "%timestamp", timestamp);
-    format = String::replace(format, "%level", logLevelToString(level));
-    format = String::replace(format, "%source", source);
-    format = String::replace(format, "%message", message);
+    return entry;
+  }
+
+  // The timestamp only changes once a second, so each thread keeps the last
+  // one it formatted.
+  const std::string& getTimestamp() const {
+    thread_local std::time_t second = -1;
+    thread_local std::string format;
+    thread_local std::string timestamp;
+
+    auto now = std::time(nullptr);
+    if (now != second || format != timestampFormat) {
+      second = now;
+      format = timestampFormat;
+      timestamp = Time::getTimestamp(timestampFormat);
+    }
 
-    return format;
+    return timestamp;
   }
 
-  std::string logLevelToString(const LogLevel& level) const {
+  const char* logLevelToString(const LogLevel& level) const {
     switch (level) {
       case LogLevel::DEBUG:
         return "DEBUG";
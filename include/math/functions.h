@@ -12,10 +12,10 @@
 #include "rng.h"
 
 static k_string get_string(const Token& term, const k_value& arg) {
-  if (!std::holds_alternative<k_string>(arg)) {
+  if (!std::holds_alternative<k_text>(arg)) {
     throw ConversionError(term, "Expected a String value.");
   }
-  return std::get<k_string>(arg);
+  return std::get<k_text>(arg).str();
 }
 
 static k_int get_integer(const Token& term, const k_value& arg) {
@@ -68,9 +68,9 @@ struct {
                std::holds_alternative<k_int>(right)) {
       result =
           std::get<double>(left) + static_cast<double>(std::get<k_int>(right));
-    } else if (std::holds_alternative<k_string>(left)) {
+    } else if (std::holds_alternative<k_text>(left)) {
       std::ostringstream build;
-      build << std::get<k_string>(left);
+      build << std::get<k_text>(left).str();
 
       if (std::holds_alternative<k_int>(right)) {
         build << std::get<k_int>(right);
@@ -78,15 +78,21 @@ struct {
         build << std::get<double>(right);
       } else if (std::holds_alternative<bool>(right)) {
         build << std::boolalpha << std::get<bool>(right);
-      } else if (std::holds_alternative<k_string>(right)) {
-        build << std::get<k_string>(right);
+      } else if (std::holds_alternative<k_text>(right)) {
+        build << std::get<k_text>(right).str();
       }
 
       result = build.str();
     } else if (std::holds_alternative<k_list>(left)) {
       auto list = std::get<k_list>(left);
-      list->elements.emplace_back(right);
+      list->elements().emplace_back(right);
       return list;
+    } else if (std::holds_alternative<k_bytes>(left) &&
+               std::holds_alternative<k_bytes>(right)) {
+      auto bytes = std::get<k_bytes>(left)->clone();
+      const auto& other = std::get<k_bytes>(right);
+      bytes->append(other->data(), other->size());
+      return bytes;
     } else {
       throw ConversionError(token, "Conversion error in addition.");
     }
@@ -116,7 +122,7 @@ struct {
       std::vector<k_value> listValues;
       bool found = false;
 
-      for (const auto& item : std::get<k_list>(left)->elements) {
+      for (const auto& item : std::get<k_list>(left)->elements()) {
         if (!found && same_value(item, right)) {
           found = true;
           continue;
@@ -252,7 +258,7 @@ struct {
                std::holds_alternative<k_int>(right)) {
       return std::get<double>(left) *
              static_cast<double>(std::get<k_int>(right));
-    } else if (std::holds_alternative<k_string>(left) &&
+    } else if (std::holds_alternative<k_text>(left) &&
                std::holds_alternative<k_int>(right)) {
       return do_string_multiplication(left, right);
     } else if (std::holds_alternative<k_list>(left) &&
@@ -273,15 +279,15 @@ struct {
                         "List multiplier must be a positive non-zero integer.");
     }
 
-    if (list->elements.size() == 0) {
+    if (list->elements().size() == 0) {
       throw SyntaxError(token, "Cannot multiply an empty list.");
     }
 
     auto newList = std::make_shared<List>();
-    auto& elements = newList->elements;
+    auto& elements = newList->elements();
 
     for (int i = 0; i < multiplier; ++i) {
-      for (const auto& item : list->elements) {
+      for (const auto& item : list->elements()) {
         elements.emplace_back(clone_value(item));
       }
     }
@@ -290,7 +296,7 @@ struct {
   }
 
   k_value do_string_multiplication(const k_value& left, const k_value& right) {
-    auto string = std::get<k_string>(left);
+    auto string = std::get<k_text>(left).str();
     auto multiplier = std::get<k_int>(right);
 
     std::ostringstream build;
@@ -656,9 +662,9 @@ struct {
 
   k_value __random__(const Token& token, const k_value& valueX,
                      const k_value& valueY) {
-    if (std::holds_alternative<k_string>(valueX)) {
+    if (std::holds_alternative<k_text>(valueX)) {
       auto limit = get_integer(token, valueY);
-      return RNG::getInstance().randomString(std::get<k_string>(valueX), limit);
+      return RNG::getInstance().randomString(std::get<k_text>(valueX).str(), limit);
     }
 
     if (std::holds_alternative<k_list>(valueX)) {
@@ -67,14 +67,14 @@ k_string RNG::randomString(const k_string& chars, size_t length) {
 }
 
 k_value RNG::randomList(k_list list, size_t length) {
-  const auto& elements = list->elements;
+  const auto& elements = list->elements();
   if (elements.empty()) {
     return std::make_shared<List>();
   }
 
   std::uniform_int_distribution<> distribution(0, elements.size() - 1);
   auto randomList = std::make_shared<List>();
-  auto& randomElements = randomList->elements;
+  auto& randomElements = randomList->elements();
 
   for (size_t i = 0; i < length; ++i) {
     randomElements.emplace_back(elements.at(distribution(generator)));
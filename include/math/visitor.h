@@ -207,12 +207,12 @@ struct NegateVisitor {
       return static_cast<k_int>(std::get<k_int>(value) == 0 ? 1 : 0);
     } else if (std::holds_alternative<double>(value)) {
       return std::get<double>(value) == 0;
-    } else if (std::holds_alternative<k_string>(value)) {
-      return std::get<k_string>(value).empty();
+    } else if (std::holds_alternative<k_text>(value)) {
+      return std::get<k_text>(value).str().empty();
     } else if (std::holds_alternative<k_list>(value)) {
-      return std::get<k_list>(value)->elements.empty();
+      return std::get<k_list>(value)->view().empty();
     } else if (std::holds_alternative<k_hash>(value)) {
-      return std::get<k_hash>(value)->keys.empty();
+      return std::get<k_hash>(value)->keys().empty();
     } else {
       throw ConversionError(token, "Unexpected value.");
     }
@@ -25,8 +25,14 @@ class Class {
   void setBaseClassName(const k_string& name) { baseClassName = name; }
   void setClassName(const k_string& name) { className = name; }
 
-  std::unordered_map<k_string, Method> getMethods() const { return methods; }
+  const std::unordered_map<k_string, Method>& getMethods() const {
+    return methods;
+  }
   const Method& getMethod(const k_string& name) { return methods[name]; }
+  const Method* findMethod(const k_string& name) const {
+    auto it = methods.find(name);
+    return it == methods.end() ? nullptr : &it->second;
+  }
 
   const k_string& getClassName() const { return className; }
   const k_string getBaseClassName() const { return baseClassName; }
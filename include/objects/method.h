@@ -5,6 +5,7 @@
 #include <string>
 #include <unordered_map>
 #include <vector>
+#include "parsing/ast.h"
 #include "parsing/tokens.h"
 #include "typing/value.h"
 
@@ -45,7 +46,7 @@ class Parameter {
   ~Parameter() { _value = static_cast<k_int>(0); }
 
   k_string getName() const { return _name; }
-  k_value getValue() { return _value; }
+  const k_value& getValue() const { return _value; }
   bool hasDefaultValue() const { return _hasDefaultValue; }
 
  private:
@@ -56,23 +57,24 @@ class Parameter {
 
 class Method {
  public:
-  void addParameterValue(const k_string& paramName, k_value value) {
-    parameterKVP[paramName] = value;
-  }
-
-  bool hasParameter(const k_string& paramName) const {
-    return parameterKVP.find(paramName) != parameterKVP.end();
-  }
-
   bool hasParameters() const { return parameters.size() > 0; }
 
-  k_value getParameterValue(const k_string& paramName) {
-    return parameterKVP[paramName];
+  void addToken(const Token& t) {
+    if (code.use_count() > 1) {
+      // The body is shared with a copy or a running stream, so detach.
+      code = std::make_shared<std::vector<Token>>(*code);
+      expressions = std::make_shared<ExpressionCache>();
+    }
+    code->emplace_back(t);
   }
 
-  void addToken(const Token& t) { code.emplace_back(t); }
+  const std::vector<Token>& getCode() const { return *code; }
 
-  const std::vector<Token>& getCode() const { return code; }
+  k_tokens getTokens() const { return code; }
+
+  const std::shared_ptr<ExpressionCache>& getExpressions() const {
+    return expressions;
+  }
 
   k_string getName() const { return _name; }
 
@@ -104,13 +106,17 @@ class Method {
 
   const std::vector<k_string>& getParameters() const { return parameters; }
 
-  const Parameter& getParameter(const k_string& name) { return _params[name]; }
+  const Parameter& getParameter(const k_string& name) const {
+    return _params.at(name);
+  }
 
  private:
   std::vector<k_string> parameters;
-  std::vector<Token> code;
+  std::shared_ptr<std::vector<Token>> code =
+      std::make_shared<std::vector<Token>>();
+  std::shared_ptr<ExpressionCache> expressions =
+      std::make_shared<ExpressionCache>();
   k_string _name;
-  std::unordered_map<k_string, k_value> parameterKVP;
   MethodFlags flags = MethodFlags::None;
 
   std::unordered_map<k_string, Parameter> _params;
@@ -1,6 +1,7 @@
 #ifndef KIWI_OBJECTS_PACKAGE_H
 #define KIWI_OBJECTS_PACKAGE_H
 
+#include <memory>
 #include <string>
 #include <vector>
 #include "parsing/tokens.h"
@@ -8,20 +9,27 @@
 
 class Package {
  public:
-  void addToken(const Token& t) { code.emplace_back(t); }
+  void addToken(const Token& t) {
+    if (code.use_count() > 1) {
+      code = std::make_shared<std::vector<Token>>(*code);
+    }
+    code->emplace_back(t);
+  }
   void setName(const k_string& name) { _name = name; }
   void setHome(const k_string& home) {
     _home = home;
     _hasHome = true;
   }
 
-  const std::vector<Token>& getCode() const { return code; }
+  const std::vector<Token>& getCode() const { return *code; }
+  k_tokens getTokens() const { return code; }
   const k_string& getName() { return _name; }
   const k_string& getHome() { return _home; }
   bool hasHome() const { return _hasHome; }
 
  private:
-  std::vector<Token> code;
+  std::shared_ptr<std::vector<Token>> code =
+      std::make_shared<std::vector<Token>>();
   k_string _name;
   k_string _home;
   bool _hasHome = false;
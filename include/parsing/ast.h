@@ -0,0 +1,558 @@
+#ifndef KIWI_PARSING_AST_H
+#define KIWI_PARSING_AST_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "parsing/keywords.h"
+#include "parsing/layout.h"
+#include "parsing/tokens.h"
+#include "typing/value.h"
+
+enum class AstKind : uint8_t {
+  Literal,
+  Variable,
+  Unary,
+  Binary,
+  LogicalOr,
+  LogicalAnd,
+  Ternary
+};
+
+// A variable read, resolved against the layout of the body it appears in.
+// `hops` is 1 if the slot belongs to the enclosing frame (a loop reading a
+// variable of its method).
+struct VariableRef {
+  k_string name;
+  k_symbol symbol = SymbolTable::None;
+  const FrameLayout* layout = nullptr;
+  size_t slot = FrameLayout::npos;
+  size_t hops = 0;
+};
+
+// A node in a compiled expression tree. `token` is the token the token-walking
+// parser would report on error, so compiled and walked expressions fail alike.
+struct AstNode {
+  AstKind kind;
+  KName op = KName::Default;
+  Token token;
+  k_value value;
+  VariableRef variable;
+  std::unique_ptr<AstNode> left;
+  std::unique_ptr<AstNode> right;
+  std::unique_ptr<AstNode> condition;
+
+  AstNode(AstKind kind, const Token& token) : kind(kind), token(token) {}
+};
+
+struct Chunk;
+class Method;
+
+// A method resolved at a call site for one class. Entries are immutable and
+// chained newest first, so call sites are read without locking.
+struct DispatchEntry {
+  k_string className;
+  uint64_t generation;
+  const Method* method;
+  const DispatchEntry* next;
+};
+
+struct CompiledExpression {
+  std::unique_ptr<AstNode> root;  // Null if the expression can't be compiled.
+  std::shared_ptr<Chunk> chunk;   // Bytecode for the VM, if enabled.
+  size_t end = 0;                 // Stream position following the expression.
+};
+
+// Compiled expressions for one token buffer, indexed by starting position.
+// Each slot is written once, so lookups are lock-free. The cache also owns the
+// frame layout of the body and the method caches of its call sites.
+class ExpressionCache {
+ public:
+  // Call sites stop caching once they have seen this many classes.
+  static constexpr size_t MaxPolymorphism = 4;
+
+  ExpressionCache() {}
+  explicit ExpressionCache(std::shared_ptr<const FrameLayout> layout)
+      : layout(std::move(layout)) {}
+  ~ExpressionCache() {
+    for (size_t i = 0; i < size; ++i) {
+      delete slots[i].load(std::memory_order_relaxed);
+    }
+  }
+
+  ExpressionCache(const ExpressionCache&) = delete;
+  ExpressionCache& operator=(const ExpressionCache&) = delete;
+
+  /// @brief Sizes the cache for a body, resolving its layout if the cache
+  /// was not given one.
+  /// @param names Names bound before the body runs.
+  void reserve(const std::vector<Token>& tokens,
+               const std::vector<k_string>& names) {
+    std::call_once(initialized, [&]() {
+      auto tokenCount = tokens.size();
+      slots.reset(new std::atomic<CompiledExpression*>[tokenCount]);
+      sites.reset(new std::atomic<const DispatchEntry*>[tokenCount]);
+      for (size_t i = 0; i < tokenCount; ++i) {
+        slots[i].store(nullptr, std::memory_order_relaxed);
+        sites[i].store(nullptr, std::memory_order_relaxed);
+      }
+      size = tokenCount;
+
+      if (!layout) {
+        layout = FrameLayout::resolve(tokens, names);
+      }
+    });
+  }
+
+  /// @brief The layout of the body. Set once `reserve` has been called.
+  const std::shared_ptr<const FrameLayout>& getLayout() const {
+    return layout;
+  }
+
+  const CompiledExpression* get(size_t position) const {
+    if (position >= size) {
+      return nullptr;
+    }
+    return slots[position].load(std::memory_order_acquire);
+  }
+
+  const CompiledExpression* put(size_t position,
+                                std::unique_ptr<CompiledExpression> entry) {
+    if (position >= size) {
+      return nullptr;
+    }
+
+    CompiledExpression* expected = nullptr;
+    auto* desired = entry.get();
+    if (slots[position].compare_exchange_strong(expected, desired,
+                                                std::memory_order_acq_rel)) {
+      return entry.release();
+    }
+
+    return expected;  // Another thread compiled it first.
+  }
+
+  /// @brief Finds the method cached at a call site for a class.
+  /// @param position The position of the method name.
+  const Method* findMethod(size_t position, const k_string& className,
+                           uint64_t generation) const {
+    if (position >= size) {
+      return nullptr;
+    }
+
+    auto entry = sites[position].load(std::memory_order_acquire);
+    for (; entry; entry = entry->next) {
+      if (entry->generation == generation && entry->className == className) {
+        return entry->method;
+      }
+    }
+
+    return nullptr;
+  }
+
+  void cacheMethod(size_t position, const k_string& className,
+                   uint64_t generation, const Method* method) {
+    if (position >= size) {
+      return;
+    }
+
+    std::lock_guard<std::mutex> lock(dispatchMutex);
+    auto head = sites[position].load(std::memory_order_relaxed);
+
+    // Entries from before a class was (re)defined are dropped.
+    if (head && head->generation != generation) {
+      head = nullptr;
+    }
+
+    size_t count = 0;
+    for (auto entry = head; entry; entry = entry->next) {
+      if (entry->className == className) {
+        return;
+      }
+      ++count;
+    }
+
+    if (count >= MaxPolymorphism) {
+      return;  // Megamorphic.
+    }
+
+    dispatchEntries.emplace_back(std::make_unique<DispatchEntry>(
+        DispatchEntry{className, generation, method, head}));
+    sites[position].store(dispatchEntries.back().get(),
+                          std::memory_order_release);
+  }
+
+ private:
+  std::once_flag initialized;
+  std::unique_ptr<std::atomic<CompiledExpression*>[]> slots;
+  size_t size = 0;
+  std::shared_ptr<const FrameLayout> layout;
+  std::unique_ptr<std::atomic<const DispatchEntry*>[]> sites;
+  std::mutex dispatchMutex;
+  std::vector<std::unique_ptr<DispatchEntry>> dispatchEntries;
+};
+
+// Compiles side-effect free expressions (literals, variable reads and
+// operators) to a tree, following the grammar of `Interpreter::parseExpression`
+// exactly. Anything else (calls, slices, member access, interpolation, ...) is
+// declined and left to the token-walking parser.
+class ExpressionCompiler {
+ public:
+  ExpressionCompiler(const std::vector<Token>& tokens, size_t position,
+                     const FrameLayout* layout)
+      : tokens(tokens), position(position), layout(layout) {}
+
+  static std::unique_ptr<CompiledExpression> compile(
+      const std::vector<Token>& tokens, size_t position,
+      const FrameLayout* layout) {
+    ExpressionCompiler compiler(tokens, position, layout);
+    auto entry = std::make_unique<CompiledExpression>();
+    entry->root = compiler.parseExpression();
+    entry->end = compiler.position;
+    return entry;
+  }
+
+ private:
+  const std::vector<Token>& tokens;
+  size_t position;
+  const FrameLayout* layout;
+  const Token streamEnd = Token::createStreamEnd();
+
+  const Token& current() const {
+    return position < tokens.size() ? tokens[position] : streamEnd;
+  }
+
+  const Token& peek() const {
+    return position + 1 < tokens.size() ? tokens[position + 1] : streamEnd;
+  }
+
+  bool canRead() const { return position < tokens.size(); }
+
+  void next() {
+    while (position < tokens.size()) {
+      ++position;
+      if (current().getType() != KTokenType::COMMENT) {
+        break;
+      }
+    }
+  }
+
+  void resolve(VariableRef& variable, const Token& token) const {
+    const auto& name = token.getText();
+    variable.name = name;
+    variable.symbol = token.getSymbol();
+
+    size_t hops = 0;
+    for (auto scope = layout; scope; scope = scope->getParent(), ++hops) {
+      auto slot = scope->indexOf(name);
+      if (slot != FrameLayout::npos) {
+        if (hops <= 1) {
+          variable.layout = layout;
+          variable.slot = slot;
+          variable.hops = hops;
+        }
+        return;
+      }
+    }
+  }
+
+  std::unique_ptr<AstNode> binary(AstKind kind, KName op,
+                                  std::unique_ptr<AstNode> left,
+                                  std::unique_ptr<AstNode> right) {
+    auto node = std::make_unique<AstNode>(kind, current());
+    node->op = op;
+    node->left = std::move(left);
+    node->right = std::move(right);
+    return node;
+  }
+
+  std::unique_ptr<AstNode> parseExpression() {
+    auto value = parseLogicalOr();
+    if (!value) {
+      return nullptr;
+    }
+
+    if (current().getType() != KTokenType::QUESTION) {
+      return value;
+    }
+
+    next();  // Skip the '?'
+    auto trueBranch = parseExpression();
+    if (!trueBranch || current().getType() != KTokenType::COLON) {
+      return nullptr;
+    }
+
+    next();  // Skip the ':'
+    auto falseBranch = parseExpression();
+    if (!falseBranch) {
+      return nullptr;
+    }
+
+    auto node = binary(AstKind::Ternary, KName::Default, std::move(trueBranch),
+                       std::move(falseBranch));
+    node->condition = std::move(value);
+    return node;
+  }
+
+  std::unique_ptr<AstNode> parseLogicalOr() {
+    auto left = parseLogicalAnd();
+
+    while (left && canRead() && current().getSubType() == KName::Ops_Or) {
+      next();
+      auto right = parseLogicalAnd();
+      if (!right) {
+        return nullptr;
+      }
+      left = binary(AstKind::LogicalOr, KName::Ops_Or, std::move(left),
+                    std::move(right));
+    }
+
+    return left;
+  }
+
+  std::unique_ptr<AstNode> parseLogicalAnd() {
+    auto left = parseBitwiseOr();
+
+    while (left && canRead() && current().getSubType() == KName::Ops_And) {
+      next();
+      auto right = parseBitwiseOr();
+      if (!right) {
+        return nullptr;
+      }
+      left = binary(AstKind::LogicalAnd, KName::Ops_And, std::move(left),
+                    std::move(right));
+    }
+
+    return left;
+  }
+
+  std::unique_ptr<AstNode> parseBitwiseOr() {
+    auto left = parseBitwiseXor();
+
+    while (left && canRead() &&
+           current().getSubType() == KName::Ops_BitwiseOr) {
+      next();
+      auto right = parseBitwiseXor();
+      if (!right) {
+        return nullptr;
+      }
+      left = binary(AstKind::Binary, KName::Ops_BitwiseOr, std::move(left),
+                    std::move(right));
+    }
+
+    return left;
+  }
+
+  std::unique_ptr<AstNode> parseBitwiseXor() {
+    auto left = parseBitwiseAnd();
+
+    while (left && canRead() &&
+           current().getSubType() == KName::Ops_BitwiseXor) {
+      next();
+      auto right = parseBitwiseAnd();
+      if (!right) {
+        return nullptr;
+      }
+      left = binary(AstKind::Binary, KName::Ops_BitwiseXor, std::move(left),
+                    std::move(right));
+    }
+
+    return left;
+  }
+
+  std::unique_ptr<AstNode> parseBitwiseAnd() {
+    auto left = parseEquality();
+
+    while (left && canRead() &&
+           current().getSubType() == KName::Ops_BitwiseAnd) {
+      next();
+      auto right = parseEquality();
+      if (!right) {
+        return nullptr;
+      }
+      left = binary(AstKind::Binary, KName::Ops_BitwiseAnd, std::move(left),
+                    std::move(right));
+    }
+
+    return left;
+  }
+
+  std::unique_ptr<AstNode> parseEquality() {
+    auto left = parseComparison();
+
+    while (left && canRead() &&
+           Operators.is_equality_op(current().getSubType())) {
+      auto op = current().getSubType();
+      next();
+      auto right = parseComparison();
+      if (!right) {
+        return nullptr;
+      }
+      left = binary(AstKind::Binary, op, std::move(left), std::move(right));
+    }
+
+    return left;
+  }
+
+  std::unique_ptr<AstNode> parseComparison() {
+    auto left = parseBitshift();
+
+    while (left && canRead() &&
+           Operators.is_comparison_op(current().getSubType())) {
+      auto op = current().getSubType();
+      next();
+      auto right = parseBitshift();
+      if (!right) {
+        return nullptr;
+      }
+      left = binary(AstKind::Binary, op, std::move(left), std::move(right));
+    }
+
+    return left;
+  }
+
+  std::unique_ptr<AstNode> parseBitshift() {
+    auto left = parseAdditive();
+
+    while (left && canRead() &&
+           Operators.is_bitwise_op(current().getSubType())) {
+      auto op = current().getSubType();
+      next();
+      auto right = parseAdditive();
+      if (!right) {
+        return nullptr;
+      }
+      left = binary(AstKind::Binary, op, std::move(left), std::move(right));
+    }
+
+    return left;
+  }
+
+  std::unique_ptr<AstNode> parseAdditive() {
+    auto left = parseMultiplicative();
+
+    while (left && canRead() &&
+           Operators.is_additive_op(current().getSubType())) {
+      auto op = current().getSubType();
+      next();
+      auto right = parseMultiplicative();
+      if (!right) {
+        return nullptr;
+      }
+      left = binary(AstKind::Binary, op, std::move(left), std::move(right));
+    }
+
+    return left;
+  }
+
+  std::unique_ptr<AstNode> parseMultiplicative() {
+    auto left = parseUnary();
+
+    while (left && canRead() &&
+           Operators.is_multiplicative_op(current().getSubType())) {
+      auto op = current().getSubType();
+      next();
+      auto right = parseUnary();
+      if (!right) {
+        return nullptr;
+      }
+      left = binary(AstKind::Binary, op, std::move(left), std::move(right));
+    }
+
+    return left;
+  }
+
+  std::unique_ptr<AstNode> parseUnary() {
+    if (canRead() && Operators.is_unary_op(current().getSubType())) {
+      auto op = current().getSubType();
+      next();
+      auto right = parseUnary();
+      if (!right) {
+        return nullptr;
+      }
+
+      auto node = std::make_unique<AstNode>(AstKind::Unary, current());
+      node->op = op;
+      node->right = std::move(right);
+      return node;
+    }
+
+    auto primary = parsePrimary();
+
+    // Member access and indexing are left to the interpreter.
+    if (canRead() && (current().getType() == KTokenType::DOT ||
+                      current().getType() == KTokenType::OPEN_BRACKET)) {
+      return nullptr;
+    }
+
+    return primary;
+  }
+
+  std::unique_ptr<AstNode> parsePrimary() {
+    const auto& token = current();
+    const auto& value = token.getValue();
+
+    if (std::holds_alternative<k_int>(value) ||
+        std::holds_alternative<double>(value) ||
+        std::holds_alternative<bool>(value)) {
+      auto node = std::make_unique<AstNode>(AstKind::Literal, token);
+      node->value = value;
+      next();
+      return node;
+    }
+
+    switch (token.getType()) {
+      case KTokenType::OPEN_PAREN: {
+        next();  // Skip "("
+        auto result = parseExpression();
+
+        if (result && current().getType() == KTokenType::CLOSE_PAREN) {
+          next();  // Skip ")"
+        }
+
+        return result;
+      }
+
+      case KTokenType::IDENTIFIER: {
+        const auto& nextType = peek().getType();
+        if (nextType == KTokenType::OPEN_BRACKET ||
+            nextType == KTokenType::QUALIFIER) {
+          return nullptr;
+        }
+
+        auto node = std::make_unique<AstNode>(AstKind::Variable, token);
+        resolve(node->variable, token);
+        next();
+
+        // Invocations are left to the interpreter.
+        if (current().getType() == KTokenType::OPEN_PAREN) {
+          return nullptr;
+        }
+
+        return node;
+      }
+
+      case KTokenType::STRING: {
+        const auto& text = token.getText();
+        if (token.getSubType() != KName::Regex &&
+            (text.find('\\') != k_string::npos ||
+             text.find("${") != k_string::npos)) {
+          return nullptr;  // Needs interpolation.
+        }
+
+        auto node = std::make_unique<AstNode>(AstKind::Literal, token);
+        node->value = token.getSubType() == KName::Regex ? value : text;
+        next();
+        return node;
+      }
+
+      default:
+        break;
+    }
+
+    return nullptr;
+  }
+};
+
+#endif
@@ -18,6 +18,7 @@ struct {
   const k_string ReadFile = "__readfile__";
   const k_string ReadLines = "__readlines__";
   const k_string ReadBytes = "__readbytes__";
+  const k_string MapFile = "__mmap__";
   const k_string WriteLine = "__writeline__";
   const k_string WriteText = "__writetext__";
   const k_string WriteBytes = "__writebytes__";
@@ -30,6 +31,15 @@ struct {
   const k_string GetFileAttributes = "__fileattrs__";
   const k_string Glob = "__glob__";
 
+  // Handles
+  const k_string OpenReader = "__openreader__";
+  const k_string OpenWriter = "__openwriter__";
+  const k_string ReadLine = "__readline__";
+  const k_string ReadChunk = "__readchunk__";
+  const k_string EndOfFile = "__eof__";
+  const k_string Flush = "__flush__";
+  const k_string Close = "__close__";
+
   // Directory operations
   const k_string ListDirectory = "__listdir__";
   const k_string MakeDirectory = "__mkdir__";
@@ -51,6 +61,7 @@ struct {
                                            ReadFile,
                                            ReadLines,
                                            ReadBytes,
+                                           MapFile,
                                            WriteText,
                                            WriteLine,
                                            WriteBytes,
@@ -70,19 +81,29 @@ struct {
                                            GetCurrentDirectory,
                                            GetFileAbsolutePath,
                                            Glob,
-                                           TempDir};
+                                           TempDir,
+                                           OpenReader,
+                                           OpenWriter,
+                                           ReadLine,
+                                           ReadChunk,
+                                           EndOfFile,
+                                           Flush,
+                                           Close};
 
   std::unordered_set<KName> st_builtins = {
       KName::Builtin_FileIO_AppendText,
       KName::Builtin_FileIO_ChangeDirectory,
+      KName::Builtin_FileIO_Close,
       KName::Builtin_FileIO_CopyFile,
       KName::Builtin_FileIO_CopyR,
       KName::Builtin_FileIO_Combine,
       KName::Builtin_FileIO_CreateFile,
       KName::Builtin_FileIO_DeleteFile,
+      KName::Builtin_FileIO_EndOfFile,
       KName::Builtin_FileIO_FileExists,
       KName::Builtin_FileIO_FileName,
       KName::Builtin_FileIO_FileSize,
+      KName::Builtin_FileIO_Flush,
       KName::Builtin_FileIO_GetCurrentDirectory,
       KName::Builtin_FileIO_GetFileAbsolutePath,
       KName::Builtin_FileIO_GetFileAttributes,
@@ -93,8 +114,13 @@ struct {
       KName::Builtin_FileIO_ListDirectory,
       KName::Builtin_FileIO_MakeDirectory,
       KName::Builtin_FileIO_MakeDirectoryP,
+      KName::Builtin_FileIO_MapFile,
       KName::Builtin_FileIO_MoveFile,
+      KName::Builtin_FileIO_OpenReader,
+      KName::Builtin_FileIO_OpenWriter,
+      KName::Builtin_FileIO_ReadChunk,
       KName::Builtin_FileIO_ReadFile,
+      KName::Builtin_FileIO_ReadLine,
       KName::Builtin_FileIO_ReadLines,
       KName::Builtin_FileIO_ReadBytes,
       KName::Builtin_FileIO_RemoveDirectory,
@@ -315,16 +341,25 @@ struct {
   const k_string Min = "min";
   const k_string Max = "max";
   const k_string ToH = "to_hash";
+  const k_string ParallelEach = "peach";
+  const k_string ParallelMap = "pmap";
+  const k_string ParallelReduce = "preduce";
+  const k_string ParallelSelect = "pselect";
 
-  std::unordered_set<k_string> builtins = {Each, Map, None, Reduce, Select,
-                                           Sort, Sum, Min,  Max,    ToH};
+  std::unordered_set<k_string> builtins = {
+      Each,         Map,         None,           Reduce, Select,
+      Sort,         Sum,         Min,            Max,    ToH,
+      ParallelEach, ParallelMap, ParallelReduce, ParallelSelect};
 
   std::unordered_set<KName> st_builtins = {
-      KName::Builtin_List_Each,   KName::Builtin_List_Map,
-      KName::Builtin_List_None,   KName::Builtin_List_Reduce,
-      KName::Builtin_List_Select, KName::Builtin_List_Sort,
-      KName::Builtin_List_ToH,    KName::Builtin_List_Sum,
-      KName::Builtin_List_Min,    KName::Builtin_List_Max};
+      KName::Builtin_List_Each,         KName::Builtin_List_Map,
+      KName::Builtin_List_None,         KName::Builtin_List_Reduce,
+      KName::Builtin_List_Select,       KName::Builtin_List_Sort,
+      KName::Builtin_List_ToH,          KName::Builtin_List_Sum,
+      KName::Builtin_List_Min,          KName::Builtin_List_Max,
+      KName::Builtin_List_ParallelEach, KName::Builtin_List_ParallelMap,
+      KName::Builtin_List_ParallelReduce,
+      KName::Builtin_List_ParallelSelect};
 
   bool is_builtin(const k_string& arg) {
     return builtins.find(arg) != builtins.end();
@@ -343,14 +378,16 @@ struct {
   const k_string Host = "__webs_host__";
   const k_string Port = "__webs_port__";
   const k_string Public = "__webs_public__";
+  const k_string Threads = "__webs_threads__";
 
-  std::unordered_set<k_string> builtins = {Get,  Post, Listen,
-                                           Host, Port, Public};
+  std::unordered_set<k_string> builtins = {Get,  Post, Listen, Host,
+                                           Port, Public, Threads};
 
   std::unordered_set<KName> st_builtins = {
       KName::Builtin_WebServer_Get,    KName::Builtin_WebServer_Post,
       KName::Builtin_WebServer_Listen, KName::Builtin_WebServer_Host,
-      KName::Builtin_WebServer_Port,   KName::Builtin_WebServer_Public};
+      KName::Builtin_WebServer_Port,   KName::Builtin_WebServer_Public,
+      KName::Builtin_WebServer_Threads};
 
   bool is_builtin(const k_string& arg) {
     return builtins.find(arg) != builtins.end();
@@ -485,6 +522,116 @@ struct {
   }
 } SysBuiltins;
 
+struct {
+  const k_string AwaitAll = "await_all";
+  const k_string AwaitAny = "await_any";
+  const k_string Cancel = "cancel_task";
+
+  std::unordered_set<k_string> builtins = {AwaitAll, AwaitAny, Cancel};
+  std::unordered_set<KName> st_builtins = {KName::Builtin_Task_AwaitAll,
+                                           KName::Builtin_Task_AwaitAny,
+                                           KName::Builtin_Task_Cancel};
+
+  bool is_builtin(const k_string& arg) {
+    return builtins.find(arg) != builtins.end();
+  }
+
+  bool is_builtin(const KName& arg) {
+    return st_builtins.find(arg) != st_builtins.end();
+  }
+} TaskBuiltins;
+
+struct {
+  const k_string Cancel = "__timer_cancel__";
+  const k_string Every = "__timer_every__";
+  const k_string Schedule = "__timer_schedule__";
+
+  std::unordered_set<k_string> builtins = {Cancel, Every, Schedule};
+  std::unordered_set<KName> st_builtins = {KName::Builtin_Timer_Cancel,
+                                           KName::Builtin_Timer_Every,
+                                           KName::Builtin_Timer_Schedule};
+
+  bool is_builtin(const k_string& arg) {
+    return builtins.find(arg) != builtins.end();
+  }
+
+  bool is_builtin(const KName& arg) {
+    return st_builtins.find(arg) != st_builtins.end();
+  }
+} TimerBuiltins;
+
+struct {
+  const k_string Close = "__chan_close__";
+  const k_string Create = "__chan_create__";
+  const k_string IsClosed = "__chan_closed__";
+  const k_string Recv = "__chan_recv__";
+  const k_string Select = "__chan_select__";
+  const k_string Send = "__chan_send__";
+  const k_string TryRecv = "__chan_tryrecv__";
+  const k_string TrySend = "__chan_trysend__";
+
+  std::unordered_set<k_string> builtins = {
+      Close, Create, IsClosed, Recv, Select, Send, TryRecv, TrySend};
+  std::unordered_set<KName> st_builtins = {
+      KName::Builtin_Channel_Close,    KName::Builtin_Channel_Create,
+      KName::Builtin_Channel_IsClosed, KName::Builtin_Channel_Recv,
+      KName::Builtin_Channel_Select,   KName::Builtin_Channel_Send,
+      KName::Builtin_Channel_TryRecv,  KName::Builtin_Channel_TrySend};
+
+  bool is_builtin(const k_string& arg) {
+    return builtins.find(arg) != builtins.end();
+  }
+
+  bool is_builtin(const KName& arg) {
+    return st_builtins.find(arg) != st_builtins.end();
+  }
+} ChannelBuiltins;
+
+struct {
+  const k_string AtomicAdd = "__atomic_add__";
+  const k_string AtomicCas = "__atomic_cas__";
+  const k_string AtomicCreate = "__atomic_create__";
+  const k_string AtomicGet = "__atomic_get__";
+  const k_string AtomicSet = "__atomic_set__";
+  const k_string MapAdd = "__cmap_add__";
+  const k_string MapClear = "__cmap_clear__";
+  const k_string MapCreate = "__cmap_create__";
+  const k_string MapGet = "__cmap_get__";
+  const k_string MapHas = "__cmap_has__";
+  const k_string MapRemove = "__cmap_remove__";
+  const k_string MapSet = "__cmap_set__";
+  const k_string MapSize = "__cmap_size__";
+  const k_string MapSnapshot = "__cmap_snapshot__";
+
+  std::unordered_set<k_string> builtins = {
+      AtomicAdd, AtomicCas, AtomicCreate, AtomicGet, AtomicSet,
+      MapAdd,    MapClear,  MapCreate,    MapGet,    MapHas,
+      MapRemove, MapSet,    MapSize,      MapSnapshot};
+  std::unordered_set<KName> st_builtins = {
+      KName::Builtin_Concurrent_AtomicAdd,
+      KName::Builtin_Concurrent_AtomicCas,
+      KName::Builtin_Concurrent_AtomicCreate,
+      KName::Builtin_Concurrent_AtomicGet,
+      KName::Builtin_Concurrent_AtomicSet,
+      KName::Builtin_Concurrent_MapAdd,
+      KName::Builtin_Concurrent_MapClear,
+      KName::Builtin_Concurrent_MapCreate,
+      KName::Builtin_Concurrent_MapGet,
+      KName::Builtin_Concurrent_MapHas,
+      KName::Builtin_Concurrent_MapRemove,
+      KName::Builtin_Concurrent_MapSet,
+      KName::Builtin_Concurrent_MapSize,
+      KName::Builtin_Concurrent_MapSnapshot};
+
+  bool is_builtin(const k_string& arg) {
+    return builtins.find(arg) != builtins.end();
+  }
+
+  bool is_builtin(const KName& arg) {
+    return st_builtins.find(arg) != st_builtins.end();
+  }
+} ConcurrentBuiltins;
+
 struct {
   const k_string Base64Encode = "__base64encode__";
   const k_string Base64Decode = "__base64decode__";
@@ -637,6 +784,8 @@ struct {
            ArgvBuiltins.is_builtin(arg) || TimeBuiltins.is_builtin(arg) ||
            FileIOBuiltIns.is_builtin(arg) || MathBuiltins.is_builtin(arg) ||
            PackageBuiltins.is_builtin(arg) || SysBuiltins.is_builtin(arg) ||
+           TaskBuiltins.is_builtin(arg) || ChannelBuiltins.is_builtin(arg) ||
+           ConcurrentBuiltins.is_builtin(arg) || TimerBuiltins.is_builtin(arg) ||
            HttpBuiltins.is_builtin(arg) || WebServerBuiltins.is_builtin(arg) ||
            LoggingBuiltins.is_builtin(arg) || EncoderBuiltins.is_builtin(arg) ||
            SerializerBuiltins.is_builtin(arg);
@@ -647,6 +796,8 @@ struct {
            ArgvBuiltins.is_builtin(arg) || TimeBuiltins.is_builtin(arg) ||
            FileIOBuiltIns.is_builtin(arg) || MathBuiltins.is_builtin(arg) ||
            PackageBuiltins.is_builtin(arg) || SysBuiltins.is_builtin(arg) ||
+           TaskBuiltins.is_builtin(arg) || ChannelBuiltins.is_builtin(arg) ||
+           ConcurrentBuiltins.is_builtin(arg) || TimerBuiltins.is_builtin(arg) ||
            HttpBuiltins.is_builtin(arg) || WebServerBuiltins.is_builtin(arg) ||
            LoggingBuiltins.is_builtin(arg) || EncoderBuiltins.is_builtin(arg) ||
            SerializerBuiltins.is_builtin(arg);
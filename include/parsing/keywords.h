@@ -228,10 +228,11 @@ struct {
   const k_string Hash = "Hash";
   const k_string Object = "Object";
   const k_string With = "Lambda";
+  const k_string Bytes = "Bytes";
   const k_string None = "None";
 
   std::unordered_set<k_string> typenames = {
-      Integer, Double, Boolean, String, List, Hash, Object, With, None};
+      Integer, Double, Boolean, String, List, Hash, Object, With, Bytes, None};
 
   bool is_typename(const k_string& arg) {
     return typenames.find(arg) != typenames.end();
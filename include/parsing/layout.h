@@ -0,0 +1,87 @@
+#ifndef KIWI_PARSING_LAYOUT_H
+#define KIWI_PARSING_LAYOUT_H
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "parsing/keywords.h"
+#include "parsing/symbols.h"
+#include "parsing/tokens.h"
+#include "typing/value.h"
+
+// Assigns a fixed slot to each parameter, local and loop variable of a body.
+// Frames running that body store those variables in a flat vector; any other
+// name (from `parse`, write-back or dynamic code) goes to a named map.
+class FrameLayout {
+ public:
+  static constexpr size_t npos = static_cast<size_t>(-1);
+
+  /// @brief Resolves the variables of a body.
+  /// @param tokens The body.
+  /// @param names Names bound before the body runs (parameters, loop
+  /// variables).
+  /// @param parent The layout of the enclosing frame, for loop bodies.
+  static std::shared_ptr<const FrameLayout> resolve(
+      const std::vector<Token>& tokens, const std::vector<k_string>& names,
+      std::shared_ptr<const FrameLayout> parent = nullptr) {
+    auto layout = std::make_shared<FrameLayout>();
+    layout->parent = std::move(parent);
+
+    auto& symbols = SymbolTable::getInstance();
+    for (const auto& name : names) {
+      if (!name.empty()) {
+        layout->add(name, symbols.intern(name));
+      }
+    }
+
+    for (size_t i = 0; i + 1 < tokens.size(); ++i) {
+      const auto& token = tokens[i];
+      if (token.getType() != KTokenType::IDENTIFIER) {
+        continue;
+      }
+
+      const auto& next = tokens[i + 1];
+      if (next.getType() == KTokenType::OPERATOR &&
+          Operators.is_assignment_operator(next.getSubType())) {
+        auto symbol = token.getSymbol();
+        layout->add(token.getText(), symbol != SymbolTable::None
+                                         ? symbol
+                                         : symbols.intern(token.getText()));
+      }
+    }
+
+    return layout;
+  }
+
+  size_t indexOf(const k_string& name) const {
+    auto it = slots.find(name);
+    return it == slots.end() ? npos : it->second;
+  }
+
+  size_t indexOf(k_symbol symbol) const {
+    auto it = symbolSlots.find(symbol);
+    return it == symbolSlots.end() ? npos : it->second;
+  }
+
+  size_t size() const { return names.size(); }
+
+  const k_string& getName(size_t slot) const { return names[slot]; }
+
+  const FrameLayout* getParent() const { return parent.get(); }
+
+ private:
+  std::unordered_map<k_string, size_t> slots;
+  std::unordered_map<k_symbol, size_t> symbolSlots;
+  std::vector<k_string> names;
+  std::shared_ptr<const FrameLayout> parent;
+
+  void add(const k_string& name, k_symbol symbol) {
+    if (slots.find(name) == slots.end()) {
+      slots[name] = names.size();
+      symbolSlots[symbol] = names.size();
+      names.push_back(name);
+    }
+  }
+};
+
+#endif
@@ -7,6 +7,7 @@
 #include <vector>
 #include "parsing/builtins.h"
 #include "parsing/keywords.h"
+#include "parsing/template.h"
 #include "parsing/tokens.h"
 #include "parsing/tokentype.h"
 #include "system/fileregistry.h"
@@ -18,6 +19,84 @@ class Lexer {
     fileId = FileRegistry::getInstance().registerFile(file);
   }
 
+  /// @brief Splits the text of a string token into literal text and lexed
+  /// `${...}` expressions.
+  static std::shared_ptr<const StringTemplate> compileTemplate(
+      const std::string& input) {
+    auto compiled = std::make_shared<StringTemplate>();
+    std::string literal;
+
+    for (size_t i = 0; i < input.length(); ++i) {
+      char c = input[i];
+
+      if (c == '$' && i + 1 < input.length() && input[i + 1] == '{') {
+        i += 2;  // Skip "${"
+        size_t start = i;
+        int braceCount = 1;
+        while (i < input.length() && braceCount > 0) {
+          if (input[i] == '{') {
+            ++braceCount;
+          } else if (input[i] == '}') {
+            --braceCount;
+          }
+          ++i;
+        }
+
+        if (braceCount != 0) {
+          compiled->malformed = true;
+          return compiled;
+        }
+
+        --i;  // Go back to the closing brace
+        Lexer lexer("", input.substr(start, i - start));
+        compiled->literalLength += literal.length();
+        compiled->segments.push_back(
+            {std::move(literal),
+             std::make_shared<const std::vector<Token>>(lexer.getAllTokens()),
+             std::make_shared<ExpressionCache>()});
+        literal.clear();
+      } else if (c == '\\') {
+        // Handle escape sequences
+        if (i + 1 < input.length()) {
+          switch (input[i + 1]) {
+            case 't':
+              literal += '\t';
+              break;
+            case 'n':
+              literal += '\n';
+              break;
+            case 'r':
+              literal += '\r';
+              break;
+            case 'b':
+              literal += '\b';
+              break;
+            case 'f':
+              literal += '\f';
+              break;
+            case '\\':
+              literal += '\\';
+              break;
+
+            default:
+              literal += input[i + 1];
+              break;
+          }
+          i++;
+        }
+      } else {
+        literal += c;
+      }
+    }
+
+    compiled->literalLength += literal.length();
+    if (compiled->segments.empty()) {
+      compiled->text = literal;
+    }
+    compiled->trailing = std::move(literal);
+    return compiled;
+  }
+
   k_stream getTokenStream() {
     return std::make_shared<TokenStream>(getAllTokens());
   }
@@ -472,6 +551,8 @@ class Lexer {
       st = KName::Types_Object;
     } else if (typeName == TypeNames.String) {
       st = KName::Types_String;
+    } else if (typeName == TypeNames.Bytes) {
+      st = KName::Types_Bytes;
     } else if (typeName == TypeNames.None) {
       st = KName::Types_None;
     }
@@ -491,6 +572,66 @@ class Lexer {
     return createToken(KTokenType::IDENTIFIER, st, builtin);
   }
 
+  Token parseChannelBuiltin(const std::string& builtin) {
+    auto st = KName::Default;
+
+    if (builtin == ChannelBuiltins.Close) {
+      st = KName::Builtin_Channel_Close;
+    } else if (builtin == ChannelBuiltins.Create) {
+      st = KName::Builtin_Channel_Create;
+    } else if (builtin == ChannelBuiltins.IsClosed) {
+      st = KName::Builtin_Channel_IsClosed;
+    } else if (builtin == ChannelBuiltins.Recv) {
+      st = KName::Builtin_Channel_Recv;
+    } else if (builtin == ChannelBuiltins.Select) {
+      st = KName::Builtin_Channel_Select;
+    } else if (builtin == ChannelBuiltins.Send) {
+      st = KName::Builtin_Channel_Send;
+    } else if (builtin == ChannelBuiltins.TryRecv) {
+      st = KName::Builtin_Channel_TryRecv;
+    } else if (builtin == ChannelBuiltins.TrySend) {
+      st = KName::Builtin_Channel_TrySend;
+    }
+
+    return createToken(KTokenType::IDENTIFIER, st, builtin);
+  }
+
+  Token parseConcurrentBuiltin(const std::string& builtin) {
+    auto st = KName::Default;
+
+    if (builtin == ConcurrentBuiltins.AtomicAdd) {
+      st = KName::Builtin_Concurrent_AtomicAdd;
+    } else if (builtin == ConcurrentBuiltins.AtomicCas) {
+      st = KName::Builtin_Concurrent_AtomicCas;
+    } else if (builtin == ConcurrentBuiltins.AtomicCreate) {
+      st = KName::Builtin_Concurrent_AtomicCreate;
+    } else if (builtin == ConcurrentBuiltins.AtomicGet) {
+      st = KName::Builtin_Concurrent_AtomicGet;
+    } else if (builtin == ConcurrentBuiltins.AtomicSet) {
+      st = KName::Builtin_Concurrent_AtomicSet;
+    } else if (builtin == ConcurrentBuiltins.MapAdd) {
+      st = KName::Builtin_Concurrent_MapAdd;
+    } else if (builtin == ConcurrentBuiltins.MapClear) {
+      st = KName::Builtin_Concurrent_MapClear;
+    } else if (builtin == ConcurrentBuiltins.MapCreate) {
+      st = KName::Builtin_Concurrent_MapCreate;
+    } else if (builtin == ConcurrentBuiltins.MapGet) {
+      st = KName::Builtin_Concurrent_MapGet;
+    } else if (builtin == ConcurrentBuiltins.MapHas) {
+      st = KName::Builtin_Concurrent_MapHas;
+    } else if (builtin == ConcurrentBuiltins.MapRemove) {
+      st = KName::Builtin_Concurrent_MapRemove;
+    } else if (builtin == ConcurrentBuiltins.MapSet) {
+      st = KName::Builtin_Concurrent_MapSet;
+    } else if (builtin == ConcurrentBuiltins.MapSize) {
+      st = KName::Builtin_Concurrent_MapSize;
+    } else if (builtin == ConcurrentBuiltins.MapSnapshot) {
+      st = KName::Builtin_Concurrent_MapSnapshot;
+    }
+
+    return createToken(KTokenType::IDENTIFIER, st, builtin);
+  }
+
   Token parseConsoleBuiltin(const std::string& builtin) {
     auto st = KName::Default;
 
@@ -598,6 +739,8 @@ class Lexer {
       st = KName::Builtin_FileIO_ReadFile;
     } else if (builtin == FileIOBuiltIns.ReadLines) {
       st = KName::Builtin_FileIO_ReadLines;
+    } else if (builtin == FileIOBuiltIns.MapFile) {
+      st = KName::Builtin_FileIO_MapFile;
     } else if (builtin == FileIOBuiltIns.ReadBytes) {
       st = KName::Builtin_FileIO_ReadBytes;
     } else if (builtin == FileIOBuiltIns.RemoveDirectory) {
@@ -606,6 +749,20 @@ class Lexer {
       st = KName::Builtin_FileIO_RemoveDirectoryF;
     } else if (builtin == FileIOBuiltIns.TempDir) {
       st = KName::Builtin_FileIO_TempDir;
+    } else if (builtin == FileIOBuiltIns.OpenReader) {
+      st = KName::Builtin_FileIO_OpenReader;
+    } else if (builtin == FileIOBuiltIns.OpenWriter) {
+      st = KName::Builtin_FileIO_OpenWriter;
+    } else if (builtin == FileIOBuiltIns.ReadLine) {
+      st = KName::Builtin_FileIO_ReadLine;
+    } else if (builtin == FileIOBuiltIns.ReadChunk) {
+      st = KName::Builtin_FileIO_ReadChunk;
+    } else if (builtin == FileIOBuiltIns.EndOfFile) {
+      st = KName::Builtin_FileIO_EndOfFile;
+    } else if (builtin == FileIOBuiltIns.Flush) {
+      st = KName::Builtin_FileIO_Flush;
+    } else if (builtin == FileIOBuiltIns.Close) {
+      st = KName::Builtin_FileIO_Close;
     } else if (builtin == FileIOBuiltIns.WriteBytes) {
       st = KName::Builtin_FileIO_WriteBytes;
     } else if (builtin == FileIOBuiltIns.WriteLine) {
@@ -632,6 +789,14 @@ class Lexer {
       st = KName::Builtin_List_Sort;
     } else if (builtin == ListBuiltins.ToH) {
       st = KName::Builtin_List_ToH;
+    } else if (builtin == ListBuiltins.ParallelEach) {
+      st = KName::Builtin_List_ParallelEach;
+    } else if (builtin == ListBuiltins.ParallelMap) {
+      st = KName::Builtin_List_ParallelMap;
+    } else if (builtin == ListBuiltins.ParallelReduce) {
+      st = KName::Builtin_List_ParallelReduce;
+    } else if (builtin == ListBuiltins.ParallelSelect) {
+      st = KName::Builtin_List_ParallelSelect;
     }
 
     return createToken(KTokenType::IDENTIFIER, st, builtin);
@@ -763,6 +928,34 @@ class Lexer {
     return createToken(KTokenType::IDENTIFIER, st, builtin);
   }
 
+  Token parseTaskBuiltin(const std::string& builtin) {
+    auto st = KName::Default;
+
+    if (builtin == TaskBuiltins.AwaitAll) {
+      st = KName::Builtin_Task_AwaitAll;
+    } else if (builtin == TaskBuiltins.AwaitAny) {
+      st = KName::Builtin_Task_AwaitAny;
+    } else if (builtin == TaskBuiltins.Cancel) {
+      st = KName::Builtin_Task_Cancel;
+    }
+
+    return createToken(KTokenType::IDENTIFIER, st, builtin);
+  }
+
+  Token parseTimerBuiltin(const std::string& builtin) {
+    auto st = KName::Default;
+
+    if (builtin == TimerBuiltins.Cancel) {
+      st = KName::Builtin_Timer_Cancel;
+    } else if (builtin == TimerBuiltins.Every) {
+      st = KName::Builtin_Timer_Every;
+    } else if (builtin == TimerBuiltins.Schedule) {
+      st = KName::Builtin_Timer_Schedule;
+    }
+
+    return createToken(KTokenType::IDENTIFIER, st, builtin);
+  }
+
   Token parseWebClientBuiltin(const std::string& builtin) {
     auto st = KName::Default;
 
@@ -800,6 +993,8 @@ class Lexer {
       st = KName::Builtin_WebServer_Port;
     } else if (builtin == WebServerBuiltins.Public) {
       st = KName::Builtin_WebServer_Public;
+    } else if (builtin == WebServerBuiltins.Threads) {
+      st = KName::Builtin_WebServer_Threads;
     }
 
     return createToken(KTokenType::IDENTIFIER, st, builtin);
@@ -874,6 +1069,10 @@ class Lexer {
   Token parseBuiltinMethod(const std::string& builtin) {
     if (ArgvBuiltins.is_builtin(builtin)) {
       return parseArgvBuiltin(builtin);
+    } else if (ChannelBuiltins.is_builtin(builtin)) {
+      return parseChannelBuiltin(builtin);
+    } else if (ConcurrentBuiltins.is_builtin(builtin)) {
+      return parseConcurrentBuiltin(builtin);
     } else if (ConsoleBuiltins.is_builtin(builtin)) {
       return parseConsoleBuiltin(builtin);
     } else if (EnvBuiltins.is_builtin(builtin)) {
@@ -890,8 +1089,12 @@ class Lexer {
       return parsePackageBuiltin(builtin);
     } else if (SysBuiltins.is_builtin(builtin)) {
       return parseSysBuiltin(builtin);
+    } else if (TaskBuiltins.is_builtin(builtin)) {
+      return parseTaskBuiltin(builtin);
     } else if (TimeBuiltins.is_builtin(builtin)) {
       return parseTimeBuiltin(builtin);
+    } else if (TimerBuiltins.is_builtin(builtin)) {
+      return parseTimerBuiltin(builtin);
     } else if (WebServerBuiltins.is_builtin(builtin)) {
       return parseWebServerBuiltin(builtin);
     } else if (HttpBuiltins.is_builtin(builtin)) {
@@ -1036,14 +1239,21 @@ class Lexer {
       st = KName::Builtin_List_ToH;
     } else if (builtin == ListBuiltins.Each) {
       st = KName::Builtin_List_Each;
+    } else if (builtin == ListBuiltins.ParallelEach) {
+      st = KName::Builtin_List_ParallelEach;
+    } else if (builtin == ListBuiltins.ParallelMap) {
+      st = KName::Builtin_List_ParallelMap;
+    } else if (builtin == ListBuiltins.ParallelReduce) {
+      st = KName::Builtin_List_ParallelReduce;
+    } else if (builtin == ListBuiltins.ParallelSelect) {
+      st = KName::Builtin_List_ParallelSelect;
     }
 
     return createToken(KTokenType::IDENTIFIER, st, builtin);
   }
 
   Token parseIdentifier(const std::string& identifier) {
-    auto st = KName::Default;
-    return createToken(KTokenType::IDENTIFIER, st, identifier);
+    return Token::createIdentifier(fileId, identifier, row, col);
   }
 
   Token parseIdentifier(char initialChar) {
@@ -1202,7 +1412,7 @@ class Lexer {
       str += '\\';
     }
 
-    return createToken(KTokenType::STRING, KName::Default, str);
+    return Token::createString(fileId, str, compileTemplate(str), row, col);
   }
 
   Token parseBlockComment() {
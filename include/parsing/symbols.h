@@ -0,0 +1,71 @@
+#ifndef KIWI_PARSING_SYMBOLS_H
+#define KIWI_PARSING_SYMBOLS_H
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include "typing/value.h"
+
+using k_symbol = uint32_t;
+
+// Process-wide table of interned identifiers. The lexer interns every
+// identifier, so equal names share one symbol and lookups keyed by symbol
+// compare integers instead of hashing strings.
+class SymbolTable {
+ public:
+  static constexpr k_symbol None = 0;
+
+  static SymbolTable& getInstance() {
+    static SymbolTable instance;
+    return instance;
+  }
+
+  SymbolTable(const SymbolTable&) = delete;
+  SymbolTable& operator=(const SymbolTable&) = delete;
+
+  k_symbol intern(const k_string& name) {
+    {
+      std::shared_lock<std::shared_mutex> lock(mutex);
+      auto it = symbols.find(name);
+      if (it != symbols.end()) {
+        return it->second;
+      }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    auto it = symbols.find(name);
+    if (it != symbols.end()) {
+      return it->second;
+    }
+
+    names.push_back(name);
+    auto symbol = static_cast<k_symbol>(names.size());
+    symbols.emplace(names.back(), symbol);
+    return symbol;
+  }
+
+  /// @brief Finds the symbol of a name without interning it.
+  /// @return `SymbolTable::None` if the name was never interned.
+  k_symbol lookup(const k_string& name) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    auto it = symbols.find(name);
+    return it == symbols.end() ? None : it->second;
+  }
+
+  const k_string& getName(k_symbol symbol) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return names.at(symbol - 1);
+  }
+
+ private:
+  SymbolTable() {}
+
+  mutable std::shared_mutex mutex;
+  std::unordered_map<k_string, k_symbol> symbols;
+  std::deque<k_string> names;  // Stable references for `getName`.
+};
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef KIWI_PARSING_TEMPLATE_H
+#define KIWI_PARSING_TEMPLATE_H
+
+#include <memory>
+#include <vector>
+#include "parsing/ast.h"
+#include "parsing/tokens.h"
+#include "typing/value.h"
+
+// A string literal split into literal text and `${...}` expressions. The
+// lexer builds one per string token, so evaluating the string only runs the
+// expressions and concatenates.
+struct StringTemplate {
+  // Literal text (escape sequences applied) followed by an expression.
+  struct Segment {
+    k_string literal;
+    k_tokens expression;
+    std::shared_ptr<ExpressionCache> expressions;
+  };
+
+  std::vector<Segment> segments;
+  k_string trailing;         // Literal text after the last expression.
+  k_text text;               // The whole string, if it has no expressions.
+  size_t literalLength = 0;  // Characters contributed by literal text.
+  bool malformed = false;    // An expression is missing its closing brace.
+};
+
+#endif
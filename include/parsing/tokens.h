@@ -3,11 +3,15 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 #include "parsing/keywords.h"
+#include "parsing/symbols.h"
 #include "parsing/tokentype.h"
 #include "typing/serializer.h"
 #include "typing/value.h"
 
+struct StringTemplate;
+
 k_string get_token_type_string(KTokenType type) {
   switch (type) {
     case KTokenType::CLOSE_BRACE:
@@ -88,6 +92,24 @@ class Token {
                   linePosition);
   }
 
+  static Token createIdentifier(const int& fileId, const k_string& text,
+                                const int& lineNumber,
+                                const int& linePosition) {
+    auto token = create(KTokenType::IDENTIFIER, KName::Default, fileId, text,
+                        lineNumber, linePosition);
+    token.symbol = SymbolTable::getInstance().intern(text);
+    return token;
+  }
+
+  static Token createString(const int& fileId, const k_string& text,
+                            std::shared_ptr<const StringTemplate> compiled,
+                            const int& lineNumber, const int& linePosition) {
+    auto token = create(KTokenType::STRING, KName::Default, fileId, text,
+                        lineNumber, linePosition);
+    token.stringTemplate = std::move(compiled);
+    return token;
+  }
+
   static Token createEmpty() {
     return create(KTokenType::ENDOFFILE, KName::Default, 0, "", 0, 0);
   }
@@ -110,6 +132,16 @@ class Token {
 
   k_value& getValue() { return value; }
 
+  const k_value& getValue() const { return value; }
+
+  /// @brief The interned name of an identifier, or `SymbolTable::None`.
+  k_symbol getSymbol() const { return symbol; }
+
+  /// @brief The split form of a string literal, or null.
+  const std::shared_ptr<const StringTemplate>& getTemplate() const {
+    return stringTemplate;
+  }
+
  private:
   KTokenType type;
   KName subType;
@@ -118,6 +150,8 @@ class Token {
   k_value value;
   int _lineNumber;
   int _linePosition;
+  k_symbol symbol = SymbolTable::None;
+  std::shared_ptr<const StringTemplate> stringTemplate;
 
   Token(const KTokenType& t, const KName& st, const int& fileId,
         const k_string& text, const k_value& v, const int& lineNumber,
@@ -128,26 +162,34 @@ class Token {
   }
 };
 
+class ExpressionCache;
+
+using k_tokens = std::shared_ptr<const std::vector<Token>>;
+
 class TokenStream {
  public:
-  TokenStream(const std::vector<Token>& tokens) : tokens(tokens) {}
-  ~TokenStream() { tokens.clear(); }
-
-  Token at(size_t pos) {
+  TokenStream(const std::vector<Token>& tokens)
+      : TokenStream(std::make_shared<const std::vector<Token>>(tokens)) {}
+  TokenStream(std::vector<Token>&& tokens)
+      : TokenStream(
+            std::make_shared<const std::vector<Token>>(std::move(tokens))) {}
+  TokenStream(k_tokens buffer) : buffer(std::move(buffer)) {}
+
+  const Token& at(size_t pos) const {
     if (pos >= tokens.size()) {
-      return Token::createStreamEnd();
+      return streamEnd();
     }
     return tokens.at(pos);
   }
 
-  Token current() {
+  const Token& current() const {
     if (position >= tokens.size()) {
-      return Token::createStreamEnd();
+      return streamEnd();
     }
     return tokens.at(position);
   }
 
-  Token previous() {
+  const Token& previous() const {
     if (position - 1 > 0) {
       return tokens.at(0);
     }
@@ -188,19 +230,29 @@ class TokenStream {
     }
   }
 
-  Token peek() {
+  const Token& peek() const {
     if (position + 1 < tokens.size()) {
       return tokens.at(position + 1);
     } else {
-      return Token::createStreamEnd();
+      return streamEnd();
     }
   }
 
   bool empty() const { return tokens.empty(); }
   bool canRead() const { return position < tokens.size(); }
 
-  std::vector<Token> tokens;
+  // The buffer is shared with its owner and never modified, so creating a
+  // stream over a method body is O(1).
+  const k_tokens buffer;
+  const std::vector<Token>& tokens = *buffer;
   size_t position = 0;
+  std::shared_ptr<ExpressionCache> expressions;
+
+ private:
+  static const Token& streamEnd() {
+    static const Token token = Token::createStreamEnd();
+    return token;
+  }
 };
 
 using k_stream = std::shared_ptr<TokenStream>;
@@ -32,6 +32,28 @@ enum KTokenType {
 enum KName {
   Builtin_Argv_GetArgv,
   Builtin_Argv_GetXarg,
+  Builtin_Channel_Close,
+  Builtin_Channel_Create,
+  Builtin_Channel_IsClosed,
+  Builtin_Channel_Recv,
+  Builtin_Channel_Select,
+  Builtin_Channel_Send,
+  Builtin_Channel_TryRecv,
+  Builtin_Channel_TrySend,
+  Builtin_Concurrent_AtomicAdd,
+  Builtin_Concurrent_AtomicCas,
+  Builtin_Concurrent_AtomicCreate,
+  Builtin_Concurrent_AtomicGet,
+  Builtin_Concurrent_AtomicSet,
+  Builtin_Concurrent_MapAdd,
+  Builtin_Concurrent_MapClear,
+  Builtin_Concurrent_MapCreate,
+  Builtin_Concurrent_MapGet,
+  Builtin_Concurrent_MapHas,
+  Builtin_Concurrent_MapRemove,
+  Builtin_Concurrent_MapSet,
+  Builtin_Concurrent_MapSize,
+  Builtin_Concurrent_MapSnapshot,
   Builtin_Console_Input,
   Builtin_Console_Silent,
   Builtin_Env_GetEnvironmentVariable,
@@ -41,14 +63,17 @@ enum KName {
   Builtin_Env_KiwiLib,
   Builtin_FileIO_AppendText,
   Builtin_FileIO_ChangeDirectory,
+  Builtin_FileIO_Close,
   Builtin_FileIO_CopyFile,
   Builtin_FileIO_CopyR,
   Builtin_FileIO_Combine,
   Builtin_FileIO_CreateFile,
   Builtin_FileIO_DeleteFile,
+  Builtin_FileIO_EndOfFile,
   Builtin_FileIO_FileExists,
   Builtin_FileIO_FileName,
   Builtin_FileIO_FileSize,
+  Builtin_FileIO_Flush,
   Builtin_FileIO_GetCurrentDirectory,
   Builtin_FileIO_GetFileAbsolutePath,
   Builtin_FileIO_GetFileAttributes,
@@ -59,9 +84,14 @@ enum KName {
   Builtin_FileIO_ListDirectory,
   Builtin_FileIO_MakeDirectory,
   Builtin_FileIO_MakeDirectoryP,
+  Builtin_FileIO_MapFile,
   Builtin_FileIO_MoveFile,
+  Builtin_FileIO_OpenReader,
+  Builtin_FileIO_OpenWriter,
   Builtin_FileIO_ReadBytes,
+  Builtin_FileIO_ReadChunk,
   Builtin_FileIO_ReadFile,
+  Builtin_FileIO_ReadLine,
   Builtin_FileIO_ReadLines,
   Builtin_FileIO_RemoveDirectory,
   Builtin_FileIO_RemoveDirectoryF,
@@ -133,6 +163,10 @@ enum KName {
   Builtin_List_Max,
   Builtin_List_Min,
   Builtin_List_None,
+  Builtin_List_ParallelEach,
+  Builtin_List_ParallelMap,
+  Builtin_List_ParallelReduce,
+  Builtin_List_ParallelSelect,
   Builtin_List_Reduce,
   Builtin_List_Select,
   Builtin_List_Sort,
@@ -160,6 +194,7 @@ enum KName {
   Builtin_WebServer_Host,
   Builtin_WebServer_Port,
   Builtin_WebServer_Public,
+  Builtin_WebServer_Threads,
   Builtin_Math_Abs,
   Builtin_Math_Acos,
   Builtin_Math_Asin,
@@ -211,6 +246,9 @@ enum KName {
   Builtin_Sys_EffectiveUserId,
   Builtin_Sys_Exec,
   Builtin_Sys_ExecOut,
+  Builtin_Task_AwaitAll,
+  Builtin_Task_AwaitAny,
+  Builtin_Task_Cancel,
   Builtin_Time_AMPM,
   Builtin_Time_Delay,
   Builtin_Time_EpochMilliseconds,
@@ -227,6 +265,9 @@ enum KName {
   Builtin_Time_WeekDay,
   Builtin_Time_Year,
   Builtin_Time_YearDay,
+  Builtin_Timer_Cancel,
+  Builtin_Timer_Every,
+  Builtin_Timer_Schedule,
   Builtin_Serializer_Deserialize,
   Builtin_Serializer_Serialize,
   KW_Abstract,
@@ -304,6 +345,7 @@ enum KName {
   Ops_Subtract,
   Ops_SubtractAssign,
   Types_Boolean,
+  Types_Bytes,
   Types_Double,
   Types_Hash,
   Types_Integer,
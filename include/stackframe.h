@@ -1,11 +1,14 @@
 #ifndef KIWI_STACKFRAME_H
 #define KIWI_STACKFRAME_H
 
+#include <deque>
 #include <memory>
 #include <string>
 #include <type_traits>
 #include <unordered_map>
+#include <vector>
 #include "objects/method.h"
+#include "parsing/layout.h"
 #include "parsing/tokens.h"
 #include "tracing/error.h"
 #include "tracing/state.h"
@@ -38,9 +41,152 @@ inline FrameFlags operator~(FrameFlags a) {
       ~static_cast<std::underlying_type_t<FrameFlags>>(a));
 }
 
+// The variables of a frame. Names in the frame's layout are kept in slots and
+// everything else in a named map.
+class FrameVariables {
+ public:
+  /// @brief Sets the layout. Must be called before any variable is stored.
+  void setLayout(std::shared_ptr<const FrameLayout> frameLayout) {
+    layout = std::move(frameLayout);
+  }
+
+  const FrameLayout* getLayout() const { return layout.get(); }
+
+  const std::shared_ptr<const FrameLayout>& getSharedLayout() const {
+    return layout;
+  }
+
+  k_value& operator[](const k_string& name) {
+    if (layout) {
+      auto slot = layout->indexOf(name);
+      if (slot != FrameLayout::npos) {
+        return define(slot);
+      }
+    }
+    return named[name];
+  }
+
+  /// @brief Stores a variable by its interned name, which skips hashing the
+  /// name when it has a slot. `symbol` may be `SymbolTable::None`.
+  k_value& at(k_symbol symbol, const k_string& name) {
+    if (layout) {
+      auto slot = slotOf(symbol, name);
+      if (slot != FrameLayout::npos) {
+        return define(slot);
+      }
+    }
+    return named[name];
+  }
+
+  k_value* find(const k_string& name) const {
+    return find(SymbolTable::None, name);
+  }
+
+  k_value* find(k_symbol symbol, const k_string& name) const {
+    if (layout) {
+      auto slot = slotOf(symbol, name);
+      if (slot != FrameLayout::npos) {
+        return atSlot(slot);
+      }
+    }
+
+    if (named.empty()) {
+      return nullptr;
+    }
+
+    auto it = named.find(name);
+    return it == named.end() ? nullptr : const_cast<k_value*>(&it->second);
+  }
+
+  k_value* atSlot(size_t slot) const {
+    if (slot < defined.size() && defined[slot]) {
+      return const_cast<k_value*>(&values[slot]);
+    }
+    return nullptr;
+  }
+
+  bool hasNamed() const { return !named.empty(); }
+
+  void erase(const k_string& name) {
+    if (layout) {
+      auto slot = layout->indexOf(name);
+      if (slot != FrameLayout::npos) {
+        if (slot < defined.size()) {
+          defined[slot] = false;
+          values[slot] = {};
+        }
+        return;
+      }
+    }
+    named.erase(name);
+  }
+
+  size_t size() const {
+    size_t count = named.size();
+    for (bool isDefined : defined) {
+      count += isDefined ? 1 : 0;
+    }
+    return count;
+  }
+
+  void clear() {
+    values.clear();
+    defined.clear();
+    named.clear();
+  }
+
+  /// @brief Replaces each value with a clone, so collections are no longer
+  /// shared with the frame this one was copied from.
+  void isolate() {
+    for (auto& value : values) {
+      value = clone_value(value);
+    }
+    for (auto& pair : named) {
+      pair.second = clone_value(pair.second);
+    }
+  }
+
+  template <typename Visitor>
+  void forEach(Visitor&& visit) const {
+    for (size_t slot = 0; slot < defined.size(); ++slot) {
+      if (defined[slot]) {
+        visit(layout->getName(slot), values[slot]);
+      }
+    }
+    for (const auto& pair : named) {
+      visit(pair.first, pair.second);
+    }
+  }
+
+ private:
+  std::shared_ptr<const FrameLayout> layout;
+  std::vector<k_value> values;
+  std::vector<bool> defined;
+  std::unordered_map<k_string, k_value> named;
+
+  size_t slotOf(k_symbol symbol, const k_string& name) const {
+    return symbol != SymbolTable::None ? layout->indexOf(symbol)
+                                       : layout->indexOf(name);
+  }
+
+  k_value& define(size_t slot) {
+    if (values.size() < layout->size()) {
+      values.resize(layout->size());
+      defined.resize(layout->size());
+    }
+    defined[slot] = true;
+    return values[slot];
+  }
+};
+
 struct CallStackFrame {
-  std::unordered_map<k_string, k_value> variables;
+  // Variables and lambdas assigned in this scope. Reads fall through to the
+  // instance variables of `scopeObject` and then to the `parent` scope, so a
+  // block scope only holds what its body writes.
+  FrameVariables variables;
   std::unordered_map<k_string, Method> lambdas;
+  std::shared_ptr<CallStackFrame> parent;
+  k_object scopeObject;
   std::vector<k_string> aliases;
   k_value returnValue;
   ErrorState errorState;
@@ -48,6 +194,7 @@ struct CallStackFrame {
   FrameFlags flags = FrameFlags::None;
 
   CallStackFrame() {}
+  CallStackFrame(const CallStackFrame&) = default;
   ~CallStackFrame() {
     variables.clear();
     lambdas.clear();
@@ -58,12 +205,55 @@ struct CallStackFrame {
     lambdas[name] = std::move(method);
   }
   bool hasAssignedLambda(const k_string& name) const {
-    return lambdas.find(name) != lambdas.end();
+    return findAssignedLambda(name) != nullptr;
+  }
+  Method& getAssignedLambda(const k_string& name) {
+    auto lambda = findAssignedLambda(name);
+    return lambda ? *lambda : lambdas[name];
+  }
+
+  Method* findAssignedLambda(const k_string& name) const {
+    for (auto scope = this; scope; scope = scope->parent.get()) {
+      auto it = scope->lambdas.find(name);
+      if (it != scope->lambdas.end()) {
+        return const_cast<Method*>(&it->second);
+      }
+    }
+    return nullptr;
   }
-  Method& getAssignedLambda(const k_string& name) { return lambdas[name]; }
 
   bool hasVariable(const k_string& name) const {
-    return variables.find(name) != variables.end();
+    return findVariable(name) != nullptr;
+  }
+
+  k_value* findVariable(const k_string& name) const {
+    return findVariable(SymbolTable::None, name);
+  }
+
+  k_value* findVariable(k_symbol symbol, const k_string& name) const {
+    for (auto scope = this; scope; scope = scope->parent.get()) {
+      if (auto variable = scope->variables.find(symbol, name)) {
+        return variable;
+      }
+
+      if (scope->scopeObject) {
+        auto& instanceVariables = scope->scopeObject->instanceVariables;
+        auto ivar = instanceVariables.find(name);
+        if (ivar != instanceVariables.end()) {
+          return &ivar->second;
+        }
+      }
+    }
+    return nullptr;
+  }
+
+  /// @brief Copies the frame for use on another thread. The copy keeps the
+  /// same parent, which the caller may relink.
+  std::shared_ptr<CallStackFrame> fork() const {
+    auto copy = std::make_shared<CallStackFrame>(*this);
+    copy->variables.isolate();
+    copy->returnValue = clone_value(returnValue);
+    return copy;
   }
 
   void setErrorState(const ErrorState& e) { errorState = e; }
@@ -89,4 +279,28 @@ struct CallStackFrame {
   }
 };
 
+// The call stack. Frames live in a deque so references to a frame stay valid
+// while deeper frames are pushed, and lookups can walk it without copying.
+class CallStack {
+ public:
+  void push(std::shared_ptr<CallStackFrame> frame) {
+    frames.push_back(std::move(frame));
+  }
+  void pop() { frames.pop_back(); }
+  std::shared_ptr<CallStackFrame>& top() { return frames.back(); }
+  bool empty() const { return frames.empty(); }
+  size_t size() const { return frames.size(); }
+
+  // Iterates from the innermost frame outward.
+  auto begin() { return frames.rbegin(); }
+  auto end() { return frames.rend(); }
+
+  // Iterates from the outermost frame inward.
+  auto rbegin() { return frames.begin(); }
+  auto rend() { return frames.end(); }
+
+ private:
+  std::deque<std::shared_ptr<CallStackFrame>> frames;
+};
+
 #endif
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define KIWI_SYSTEM_FILEREGISTRY_H
 
 #include <fstream>
+#include <mutex>
 #include <string>
 #include <sstream>
 #include <unordered_map>
@@ -24,6 +25,7 @@ class FileRegistry {
     while (std::getline(stream, line)) {
       lines.emplace_back(line);
     }
+    std::lock_guard<std::mutex> lock(mutex);
     int id = nextId++;
     registry[id] = filePath;
     linesRegistry[id] = std::move(lines);
@@ -31,6 +33,7 @@ class FileRegistry {
   }
 
   std::string getFilePath(int id) const {
+    std::lock_guard<std::mutex> lock(mutex);
     auto it = registry.find(id);
     if (it != registry.end()) {
       return it->second;
@@ -39,6 +42,7 @@ class FileRegistry {
   }
 
   std::vector<std::string> getFileLines(int id) const {
+    std::lock_guard<std::mutex> lock(mutex);
     auto it = linesRegistry.find(id);
     if (it != linesRegistry.end()) {
       return it->second;
@@ -52,6 +56,7 @@ class FileRegistry {
   std::unordered_map<int, std::string> registry;
   std::unordered_map<int, std::vector<std::string>> linesRegistry;
   int nextId;
+  mutable std::mutex mutex;  // Lexers may run on task threads.
 };
 
 #endif
\ No newline at end of file
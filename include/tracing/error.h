@@ -263,6 +263,31 @@ class FileSystemError : public KiwiError {
       : KiwiError(token, "FileSystemError", message) {}
 };
 
+class TaskTimeoutError : public KiwiError {
+ public:
+  TaskTimeoutError(const Token& token, const std::string& message)
+      : KiwiError(token, "TaskTimeoutError", message) {}
+};
+
+class TaskCancelledError : public KiwiError {
+ public:
+  TaskCancelledError(const Token& token,
+                     const std::string& message = "The task was cancelled.")
+      : KiwiError(token, "TaskCancelledError", message) {}
+};
+
+class ChannelError : public KiwiError {
+ public:
+  ChannelError(const Token& token, const std::string& message)
+      : KiwiError(token, "ChannelError", message) {}
+};
+
+class VirtualMachineError : public KiwiError {
+ public:
+  VirtualMachineError(const Token& token, const std::string& message)
+      : KiwiError(token, "VirtualMachineError", message) {}
+};
+
 template <typename T>
 class Thrower {
  public:
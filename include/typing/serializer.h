@@ -20,7 +20,7 @@ struct Serializer {
 
     } else if (std::holds_alternative<bool>(v)) {
       return TypeNames.Boolean;
-    } else if (std::holds_alternative<k_string>(v)) {
+    } else if (std::holds_alternative<k_text>(v)) {
       return TypeNames.String;
     } else if (std::holds_alternative<k_list>(v)) {
       return TypeNames.List;
@@ -30,6 +30,10 @@ struct Serializer {
       return std::get<k_object>(v)->className;
     } else if (std::holds_alternative<k_lambda>(v)) {
       return TypeNames.With;
+    } else if (std::holds_alternative<k_handle>(v)) {
+      return std::get<k_handle>(v)->typeName();
+    } else if (std::holds_alternative<k_bytes>(v)) {
+      return TypeNames.Bytes;
     }
 
     return "";
@@ -40,7 +44,7 @@ struct Serializer {
       return std::get<k_list>(rhsValues);
     } else {
       auto newList = std::make_shared<List>();
-      newList->elements.emplace_back(rhsValues);
+      newList->elements().emplace_back(rhsValues);
       return newList;
     }
   }
@@ -54,11 +58,11 @@ struct Serializer {
       sv << std::get<double>(v);
     } else if (std::holds_alternative<bool>(v)) {
       sv << std::boolalpha << std::get<bool>(v);
-    } else if (std::holds_alternative<k_string>(v)) {
+    } else if (std::holds_alternative<k_text>(v)) {
       if (wrapStrings) {
-        sv << "\"" << std::get<k_string>(v) << "\"";
+        sv << "\"" << std::get<k_text>(v).str() << "\"";
       } else {
-        sv << std::get<k_string>(v);
+        sv << std::get<k_text>(v).str();
       }
     } else if (std::holds_alternative<k_list>(v)) {
       sv << serialize_list(std::get<k_list>(v));
@@ -68,6 +72,10 @@ struct Serializer {
       sv << basic_serialize_object(std::get<k_object>(v));
     } else if (std::holds_alternative<k_lambda>(v)) {
       sv << basic_serialize_lambda(std::get<k_lambda>(v));
+    } else if (std::holds_alternative<k_handle>(v)) {
+      sv << basic_serialize_handle(std::get<k_handle>(v));
+    } else if (std::holds_alternative<k_bytes>(v)) {
+      sv << serialize_bytes(std::get<k_bytes>(v));
     }
 
     return sv.str();
@@ -77,12 +85,12 @@ struct Serializer {
     std::ostringstream sv;
     sv << "[";
 
-    for (auto it = list->elements.begin(); it != list->elements.end(); ++it) {
-      if (it != list->elements.begin()) {
+    for (auto it = list->view().begin(); it != list->view().end(); ++it) {
+      if (it != list->view().begin()) {
         sv << ", ";
       }
 
-      if (std::holds_alternative<k_string>(*it)) {
+      if (std::holds_alternative<k_text>(*it)) {
         sv << "\"" << serialize(*it) << "\"";
       } else {
         sv << serialize(*it);
@@ -102,8 +110,8 @@ struct Serializer {
       sv << std::get<double>(v);
     } else if (std::holds_alternative<bool>(v)) {
       sv << std::boolalpha << std::get<bool>(v);
-    } else if (std::holds_alternative<k_string>(v)) {
-      sv << "\"" << std::get<k_string>(v) << "\"";
+    } else if (std::holds_alternative<k_text>(v)) {
+      sv << "\"" << std::get<k_text>(v).str() << "\"";
     } else if (std::holds_alternative<k_list>(v)) {
       sv << pretty_serialize_list(std::get<k_list>(v), indent);
     } else if (std::holds_alternative<k_hash>(v)) {
@@ -112,6 +120,10 @@ struct Serializer {
       sv << basic_serialize_object(std::get<k_object>(v));
     } else if (std::holds_alternative<k_lambda>(v)) {
       sv << basic_serialize_lambda(std::get<k_lambda>(v));
+    } else if (std::holds_alternative<k_handle>(v)) {
+      sv << basic_serialize_handle(std::get<k_handle>(v));
+    } else if (std::holds_alternative<k_bytes>(v)) {
+      sv << serialize_bytes(std::get<k_bytes>(v));
     }
 
     return sv.str();
@@ -130,7 +142,7 @@ struct Serializer {
     std::string indentString(indent + 2, ' ');
     bool first = true;
 
-    for (const auto& item : list->elements) {
+    for (const auto& item : list->view()) {
       if (!first) {
         sv << ", ";
       } else {
@@ -145,7 +157,7 @@ struct Serializer {
                                                  indent + 2, true);
       } else if (std::holds_alternative<k_hash>(item)) {
         sv << pretty_serialize_hash(std::get<k_hash>(item), indent + 2);
-      } else if (std::holds_alternative<k_string>(item)) {
+      } else if (std::holds_alternative<k_text>(item)) {
         sv << "\"" << serialize(item) << "\"";
       } else {
         sv << serialize(item);
@@ -165,8 +177,8 @@ struct Serializer {
     sv << "[" << std::endl;
     std::string indentString(indent + 2, ' ');
 
-    for (auto it = list->elements.begin(); it != list->elements.end(); ++it) {
-      if (it != list->elements.begin()) {
+    for (auto it = list->view().begin(); it != list->view().end(); ++it) {
+      if (it != list->view().begin()) {
         sv << "," << std::endl;
       }
 
@@ -176,7 +188,7 @@ struct Serializer {
         sv << pretty_serialize_list(std::get<k_list>(*it), indent + 2);
       } else if (std::holds_alternative<k_hash>(*it)) {
         sv << pretty_serialize_hash(std::get<k_hash>(*it), indent + 2);
-      } else if (std::holds_alternative<k_string>(*it)) {
+      } else if (std::holds_alternative<k_text>(*it)) {
         sv << "\"" << serialize(*it) << "\"";
       } else {
         sv << serialize(*it);
@@ -193,7 +205,7 @@ struct Serializer {
     std::string indentString(indent + 2, ' ');
 
     bool first = true;
-    auto& keys = hash->keys;
+    const auto& keys = hash->keys();
     for (const auto& key : keys) {
       if (!first) {
         sv << "," << std::endl;
@@ -202,12 +214,12 @@ struct Serializer {
       }
       sv << indentString << "\"" << key << "\": ";
 
-      auto v = hash->get(key);
+      const auto& v = hash->view().at(key);
       if (std::holds_alternative<k_hash>(v)) {
         sv << pretty_serialize_hash(std::get<k_hash>(v), indent + 2);
       } else if (std::holds_alternative<k_list>(v)) {
         sv << pretty_serialize_list(std::get<k_list>(v), indent + 2);
-      } else if (std::holds_alternative<k_string>(v)) {
+      } else if (std::holds_alternative<k_text>(v)) {
         sv << "\"" << serialize(v) << "\"";
       } else {
         sv << serialize(v, true);
@@ -220,9 +232,9 @@ struct Serializer {
 
   static k_list get_hash_keys_list(const k_hash& hash) {
     auto keys = std::make_shared<List>();
-    auto& elements = keys->elements;
+    auto& elements = keys->elements();
 
-    for (const auto& key : hash->keys) {
+    for (const auto& key : hash->keys()) {
       elements.emplace_back(key);
     }
 
@@ -231,10 +243,10 @@ struct Serializer {
 
   static k_list get_hash_values_list(const k_hash& hash) {
     auto values = std::make_shared<List>();
-    auto& elements = values->elements;
+    auto& elements = values->elements();
 
-    for (const auto& key : hash->keys) {
-      elements.emplace_back(hash->kvp[key]);
+    for (const auto& key : hash->keys()) {
+      elements.emplace_back(hash->get(key));
     }
 
     return values;
@@ -256,12 +268,31 @@ struct Serializer {
     return "[" + TypeNames.With + "(identifier=" + lambda->identifier + ")]";
   }
 
+  static k_string serialize_bytes(const k_bytes& bytes) {
+    std::ostringstream sv;
+    sv << "[";
+
+    for (size_t i = 0; i < bytes->size(); ++i) {
+      if (i > 0) {
+        sv << ", ";
+      }
+      sv << static_cast<unsigned>(bytes->data()[i]);
+    }
+
+    sv << "]";
+    return sv.str();
+  }
+
+  static k_string basic_serialize_handle(const k_handle& handle) {
+    return "[" + handle->typeName() + "]";
+  }
+
   static k_string serialize_hash(const k_hash& hash) {
     std::ostringstream sv;
     sv << "{";
 
     bool first = true;
-    auto& keys = hash->keys;
+    const auto& keys = hash->keys();
 
     for (const auto& key : keys) {
       if (!first) {
@@ -271,7 +302,7 @@ struct Serializer {
       }
 
       sv << "\"" << key << "\": ";
-      auto v = hash->get(key);
+      const auto& v = hash->view().at(key);
 
       if (std::holds_alternative<k_hash>(v)) {
         sv << serialize(v);
@@ -2,9 +2,11 @@
 #define KIWI_TYPING_VALUETYPE_H
 
 #include <algorithm>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <variant>
 #include <vector>
@@ -14,6 +16,8 @@ struct Hash;
 struct List;
 struct Object;
 struct LambdaRef;
+struct Handle;
+struct Bytes;
 
 typedef long long k_int;
 typedef std::string k_string;
@@ -27,21 +31,73 @@ enum class ValueType {
   List,
   Hash,
   Object,
-  Lambda
+  Lambda,
+  Handle,
+  Bytes
 };
 
+// A string value. The text is immutable and shared between copies, so the
+// string alternative is no wider than the pointer alternatives and copying a
+// value never copies its characters.
+struct Text {
+  Text() : text(empty()) {}
+  Text(const k_string& text) : text(std::make_shared<const k_string>(text)) {}
+  Text(k_string&& text)
+      : text(std::make_shared<const k_string>(std::move(text))) {}
+  Text(const char* text) : text(std::make_shared<const k_string>(text)) {}
+
+  // A moved-from value is left as the empty string, not a null pointer.
+  Text(const Text&) = default;
+  Text(Text&& other) noexcept : text(std::move(other.text)) {
+    other.text = empty();
+  }
+  Text& operator=(const Text&) = default;
+  Text& operator=(Text&& other) noexcept {
+    text.swap(other.text);
+    other.text = empty();
+    return *this;
+  }
+
+  const k_string& str() const { return *text; }
+
+  friend bool operator==(const Text& lhs, const Text& rhs) {
+    return lhs.text == rhs.text || *lhs.text == *rhs.text;
+  }
+  friend bool operator!=(const Text& lhs, const Text& rhs) {
+    return !(lhs == rhs);
+  }
+  friend bool operator<(const Text& lhs, const Text& rhs) {
+    return *lhs.text < *rhs.text;
+  }
+
+ private:
+  std::shared_ptr<const k_string> text;
+
+  static const std::shared_ptr<const k_string>& empty() {
+    static const auto instance = std::make_shared<const k_string>();
+    return instance;
+  }
+};
+
+using k_text = Text;
 using k_hash = std::shared_ptr<Hash>;
 using k_list = std::shared_ptr<List>;
 using k_object = std::shared_ptr<Object>;
 using k_lambda = std::shared_ptr<LambdaRef>;
+using k_handle = std::shared_ptr<Handle>;
+using k_bytes = std::shared_ptr<Bytes>;
 
 inline void hash_combine(std::size_t& seed, std::size_t hash);
 std::size_t hash_hash(const k_hash& hash);
 std::size_t hash_list(const k_list& list);
 std::size_t hash_object(const k_object& object);
+std::size_t hash_bytes(const k_bytes& bytes);
+
+using k_value = std::variant<k_int, double, bool, k_text, k_list, k_hash,
+                             k_object, k_lambda, k_handle, k_bytes>;
 
-using k_value = std::variant<k_int, double, bool, k_string, k_list, k_hash,
-                             k_object, k_lambda>;
+static_assert(sizeof(k_value) <= 3 * sizeof(void*),
+              "k_value should be no wider than a shared_ptr and its tag");
 
 // Specialize a struct for hash computation for k_value
 namespace std {
@@ -55,8 +111,8 @@ struct hash<k_value> {
         return std::hash<double>()(std::get<double>(v));
       case 2:  // bool
         return std::hash<bool>()(std::get<bool>(v));
-      case 3:  // k_string
-        return std::hash<k_string>()(std::get<k_string>(v));
+      case 3:  // k_text
+        return std::hash<k_string>()(std::get<k_text>(v).str());
       case 4:  // k_list
         return hash_list(std::get<k_list>(v));
       case 5:  // k_hash
@@ -65,6 +121,10 @@ struct hash<k_value> {
         return hash_object(std::get<k_object>(v));
       case 7:  // k_lambda
         return false;
+      case 8:  // k_handle
+        return std::hash<k_handle>()(std::get<k_handle>(v));
+      case 9:  // k_bytes
+        return hash_bytes(std::get<k_bytes>(v));
       default:
         // Fallback for unknown types
         return 0;
@@ -73,40 +133,190 @@ struct hash<k_value> {
 };
 }  // namespace std
 
+bool is_container(const k_value& value) {
+  return std::holds_alternative<k_list>(value) ||
+         std::holds_alternative<k_hash>(value) ||
+         std::holds_alternative<k_object>(value);
+}
+
+// Lists and hashes share their storage with their clones and copy it on the
+// first write. Reading an element that is itself a container also copies,
+// since the caller may mutate it.
 struct List {
-  std::vector<k_value> elements;
+  List() : storage(std::make_shared<std::vector<k_value>>()) {}
+  List(const std::vector<k_value>& values)
+      : storage(std::make_shared<std::vector<k_value>>(values)) {}
+  List(std::vector<k_value>&& values)
+      : storage(std::make_shared<std::vector<k_value>>(std::move(values))) {}
+
+  /// @brief The elements, for writing or for reading values that are kept.
+  std::vector<k_value>& elements() {
+    detach();
+    return *storage;
+  }
+
+  /// @brief The elements, for reads that neither keep nor mutate them.
+  const std::vector<k_value>& view() const { return *storage; }
+
+  /// @brief Reads an element, copying the storage first if the element is a
+  /// container shared with a clone.
+  const k_value& at(size_t index) {
+    if (is_container(storage->at(index))) {
+      detach();
+    }
+    return storage->at(index);
+  }
 
-  List() {}
-  List(const std::vector<k_value>& values) : elements(values) {}
+  k_list clone() const;
+
+  /// @brief Takes a private copy of the storage if a clone shares it.
+  void detach();
+
+ private:
+  std::shared_ptr<std::vector<k_value>> storage;
+
+  explicit List(std::shared_ptr<std::vector<k_value>> storage)
+      : storage(std::move(storage)) {}
 };
 
 struct Hash {
-  std::unordered_map<k_string, k_value> kvp;
-  std::vector<k_string> keys;
+  Hash() : storage(std::make_shared<Storage>()) {}
 
-  int size() const { return keys.size(); }
+  int size() const { return storage->keys.size(); }
 
-  bool hasKey(const k_string& key) const { return kvp.find(key) != kvp.end(); }
+  bool hasKey(const k_string& key) const {
+    return storage->kvp.find(key) != storage->kvp.end();
+  }
 
   void add(const k_string& key, k_value value) {
+    detach();
     if (!hasKey(key)) {
-      keys.emplace_back(key);
+      storage->keys.emplace_back(key);
     }
-    kvp[key] = value;
+    storage->kvp[key] = value;
   }
 
-  k_value get(const k_string& key) { return kvp[key]; }
+  k_value get(const k_string& key) {
+    auto it = storage->kvp.find(key);
+    if (it == storage->kvp.end() || is_container(it->second)) {
+      detach();
+      return storage->kvp[key];
+    }
+    return it->second;
+  }
 
   void remove(const k_string& key) {
-    kvp.erase(key);
+    detach();
+    auto& keys = storage->keys;
+    storage->kvp.erase(key);
     auto newEnd = std::remove(keys.begin(), keys.end(), key);
     keys.erase(newEnd, keys.end());
   }
 
   void merge(const k_hash& other) {
-    for (const auto& key : other->keys) {
-      add(key, other->kvp[key]);
+    for (const auto& key : other->keys()) {
+      add(key, other->get(key));
+    }
+  }
+
+  void clear() {
+    detach();
+    storage->keys.clear();
+    storage->kvp.clear();
+  }
+
+  /// @brief The keys in insertion order.
+  const std::vector<k_string>& keys() const { return storage->keys; }
+
+  /// @brief The entries, for reads that neither keep nor mutate the values.
+  const std::unordered_map<k_string, k_value>& view() const {
+    return storage->kvp;
+  }
+
+  k_hash clone() const;
+
+ private:
+  struct Storage {
+    std::unordered_map<k_string, k_value> kvp;
+    std::vector<k_string> keys;
+  };
+
+  std::shared_ptr<Storage> storage;
+
+  explicit Hash(std::shared_ptr<Storage> storage)
+      : storage(std::move(storage)) {}
+
+  void detach();
+};
+
+// A byte buffer, held as one byte per byte. A slice shares the bytes of the
+// buffer it was cut from, and a buffer copies its bytes on the first write
+// while any are shared.
+struct Bytes {
+  Bytes() : Bytes(std::vector<uint8_t>()) {}
+  explicit Bytes(std::vector<uint8_t> bytes) { adopt(std::move(bytes)); }
+
+  /// @brief Wraps bytes that `owner` keeps alive. They are copied before any
+  /// write, never written in place.
+  Bytes(std::shared_ptr<const void> owner, const uint8_t* data, size_t size)
+      : owner(std::move(owner)), begin(data), length(size) {}
+
+  const uint8_t* data() const { return begin; }
+  size_t size() const { return length; }
+
+  /// @brief The bytes as characters, for searching and conversion.
+  std::string_view view() const {
+    return std::string_view(reinterpret_cast<const char*>(begin), length);
+  }
+
+  /// @brief A slice of `count` bytes from `start`, sharing these bytes.
+  k_bytes slice(size_t start, size_t count) const {
+    return std::make_shared<Bytes>(owner, begin + start, count);
+  }
+
+  void set(size_t index, uint8_t byte) {
+    detach();
+    buffer->at(index) = byte;
+  }
+
+  void push(uint8_t byte) {
+    detach();
+    buffer->push_back(byte);
+    refresh();
+  }
+
+  void append(const uint8_t* data, size_t size) {
+    detach();
+    buffer->insert(buffer->end(), data, data + size);
+    refresh();
+  }
+
+  k_bytes clone() const { return std::make_shared<Bytes>(*this); }
+
+ private:
+  std::shared_ptr<const void> owner;
+  std::vector<uint8_t>* buffer = nullptr;  // Set while the bytes are ours.
+  const uint8_t* begin = nullptr;
+  size_t length = 0;
+
+  void adopt(std::vector<uint8_t> bytes) {
+    auto storage = std::make_shared<std::vector<uint8_t>>(std::move(bytes));
+    buffer = storage.get();
+    owner = std::move(storage);
+    refresh();
+  }
+
+  void refresh() {
+    begin = buffer->data();
+    length = buffer->size();
+  }
+
+  /// @brief Takes a private copy of the bytes if anything else shares them.
+  void detach() {
+    if (buffer && owner.use_count() == 1) {
+      return;
     }
+    adopt(std::vector<uint8_t>(begin, begin + length));
   }
 };
 
@@ -126,13 +336,22 @@ struct LambdaRef {
   LambdaRef(const k_string& identifier) : identifier(identifier) {}
 };
 
+// A resource the script holds open, such as a file reader. Copies of the value
+// share the resource, which is released along with the last of them.
+struct Handle {
+  virtual ~Handle() = default;
+
+  /// @brief The name reported as the type of the value.
+  virtual k_string typeName() const = 0;
+};
+
 inline void hash_combine(std::size_t& seed, std::size_t hash) {
   seed ^= hash + 0x9e3779b9 + (seed << 6) + (seed >> 2);
 }
 
 std::size_t hash_list(const k_list& list) {
   std::size_t seed = 0;
-  for (const auto& elem : list->elements) {
+  for (const auto& elem : list->view()) {
     hash_combine(seed, std::hash<k_value>()(elem));
   }
   return seed;
@@ -140,7 +359,7 @@ std::size_t hash_list(const k_list& list) {
 
 std::size_t hash_hash(const k_hash& hash) {
   std::size_t seed = 0;
-  for (const auto& pair : hash->kvp) {
+  for (const auto& pair : hash->view()) {
     hash_combine(seed, std::hash<k_string>()(pair.first));
     hash_combine(seed, std::hash<k_value>()(pair.second));
   }
@@ -156,6 +375,10 @@ std::size_t hash_object(const k_object& object) {
   return seed;
 }
 
+std::size_t hash_bytes(const k_bytes& bytes) {
+  return std::hash<std::string_view>()(bytes->view());
+}
+
 struct ValueComparator {
   bool operator()(const k_value& lhs, const k_value& rhs) const {
     if (lhs.index() != rhs.index()) {
@@ -169,8 +392,8 @@ struct ValueComparator {
         return *std::get_if<double>(&lhs) < *std::get_if<double>(&rhs);
       case 2:  // bool
         return *std::get_if<bool>(&lhs) < *std::get_if<bool>(&rhs);
-      case 3:  // k_string
-        return *std::get_if<k_string>(&lhs) < *std::get_if<k_string>(&rhs);
+      case 3:  // k_text
+        return std::get_if<k_text>(&lhs)->str() < std::get_if<k_text>(&rhs)->str();
       default:
         auto lhs_hash = std::hash<k_value>()(lhs);
         auto rhs_hash = std::hash<k_value>()(rhs);
@@ -184,30 +407,55 @@ struct ValueComparator {
 };
 
 void sort_list(List& list) {
-  std::sort(list.elements.begin(), list.elements.end(), ValueComparator());
+  auto& elements = list.elements();
+  std::sort(elements.begin(), elements.end(), ValueComparator());
 }
 
 k_value clone_value(const k_value& original);
 k_hash clone_hash(const k_hash& original);
 k_list clone_list(const k_list& original);
 
-k_list clone_list(const k_list& original) {
-  k_list clone = std::make_shared<List>();
-  auto& cloneElements = clone->elements;
-  auto& elements = original->elements;
-  for (const auto& element : elements) {
-    cloneElements.push_back(clone_value(element));
+k_list List::clone() const {
+  return k_list(new List(storage));
+}
+
+void List::detach() {
+  if (storage.use_count() == 1) {
+    return;
   }
-  return clone;
+
+  auto copy = std::make_shared<std::vector<k_value>>();
+  copy->reserve(storage->size());
+  for (const auto& element : *storage) {
+    copy->push_back(clone_value(element));
+  }
+  storage = std::move(copy);
 }
 
-k_hash clone_hash(const k_hash& original) {
-  k_hash clone = std::make_shared<Hash>();
-  auto& keys = original->keys;
-  for (const auto& key : keys) {
-    clone->add(key, clone_value(original->get(key)));
+k_hash Hash::clone() const {
+  return k_hash(new Hash(storage));
+}
+
+void Hash::detach() {
+  if (storage.use_count() == 1) {
+    return;
   }
-  return clone;
+
+  auto copy = std::make_shared<Storage>();
+  copy->keys = storage->keys;
+  copy->kvp.reserve(storage->kvp.size());
+  for (const auto& pair : storage->kvp) {
+    copy->kvp.emplace(pair.first, clone_value(pair.second));
+  }
+  storage = std::move(copy);
+}
+
+k_list clone_list(const k_list& original) {
+  return original->clone();
+}
+
+k_hash clone_hash(const k_hash& original) {
+  return original->clone();
 }
 
 k_value clone_value(const k_value& original) {
@@ -218,8 +466,8 @@ k_value clone_value(const k_value& original) {
       return std::get<double>(original);
     case 2:  // bool
       return std::get<bool>(original);
-    case 3:  // k_string
-      return std::get<k_string>(original);
+    case 3:  // k_text
+      return std::get<k_text>(original).str();
     case 4:  // k_list
       return clone_list(std::get<k_list>(original));
     case 5:  // k_hash
@@ -228,6 +476,10 @@ k_value clone_value(const k_value& original) {
       return std::make_shared<Object>(*std::get<k_object>(original));
     case 7:  // k_lambda
       return std::make_shared<LambdaRef>(*std::get<k_lambda>(original));
+    case 8:  // k_handle
+      return std::get<k_handle>(original);
+    case 9:  // k_bytes
+      return std::get<k_bytes>(original)->clone();
     default:
       throw std::runtime_error("Unsupported type for cloning");
   }
@@ -245,8 +497,10 @@ bool same_value(const k_value& v1, const k_value& v2) {
       return *std::get_if<double>(&v1) == *std::get_if<double>(&v2);
     case 2:  // bool
       return *std::get_if<bool>(&v1) == *std::get_if<bool>(&v2);
-    case 3:  // k_string
-      return *std::get_if<k_string>(&v1) == *std::get_if<k_string>(&v2);
+    case 3:  // k_text
+      return std::get_if<k_text>(&v1)->str() == std::get_if<k_text>(&v2)->str();
+    case 9:  // k_bytes
+      return std::get<k_bytes>(v1)->view() == std::get<k_bytes>(v2)->view();
     default:
       return std::hash<k_value>()(v1) == std::hash<k_value>()(v2);
   }
@@ -264,8 +518,8 @@ bool lt_value(const k_value& lhs, const k_value& rhs) {
       return std::get<double>(lhs) < std::get<double>(rhs);
     case 2:  // bool
       return std::get<bool>(lhs) < std::get<bool>(rhs);
-    case 3:  // k_string
-      return std::get<k_string>(lhs) < std::get<k_string>(rhs);
+    case 3:  // k_text
+      return std::get<k_text>(lhs).str() < std::get<k_text>(rhs).str();
     case 4:  // k_list
       return hash_list(std::get<k_list>(lhs)) <
              hash_list(std::get<k_list>(rhs));
@@ -275,6 +529,8 @@ bool lt_value(const k_value& lhs, const k_value& rhs) {
     case 6:  // k_object
       return hash_object(std::get<k_object>(lhs)) <
              hash_object(std::get<k_object>(rhs));
+    case 9:  // k_bytes
+      return std::get<k_bytes>(lhs)->view() < std::get<k_bytes>(rhs)->view();
     default:
       return false;
   }
@@ -292,8 +548,8 @@ bool gt_value(const k_value& lhs, const k_value& rhs) {
       return std::get<double>(lhs) > std::get<double>(rhs);
     case 2:  // bool
       return std::get<bool>(lhs) > std::get<bool>(rhs);
-    case 3:  // k_string
-      return std::get<k_string>(lhs) > std::get<k_string>(rhs);
+    case 3:  // k_text
+      return std::get<k_text>(lhs).str() > std::get<k_text>(rhs).str();
     case 4:  // k_list
       return hash_list(std::get<k_list>(lhs)) >
              hash_list(std::get<k_list>(rhs));
@@ -303,6 +559,8 @@ bool gt_value(const k_value& lhs, const k_value& rhs) {
     case 6:  // k_object
       return hash_object(std::get<k_object>(lhs)) >
              hash_object(std::get<k_object>(rhs));
+    case 9:  // k_bytes
+      return std::get<k_bytes>(lhs)->view() > std::get<k_bytes>(rhs)->view();
     default:
       return false;
   }
@@ -312,7 +570,7 @@ k_value sum_listvalue(k_list list) {
   double sum = 0;
   bool hasDouble = false;
 
-  for (const auto& val : list->elements) {
+  for (const auto& val : list->view()) {
     if (std::holds_alternative<k_int>(val)) {
       sum += std::get<k_int>(val);
     } else if (std::holds_alternative<double>(val)) {
@@ -329,7 +587,7 @@ k_value sum_listvalue(k_list list) {
 }
 
 k_value min_listvalue(k_list list) {
-  const auto& elements = list->elements;
+  const auto& elements = list->elements();
 
   if (elements.empty()) {
     return {};
@@ -346,7 +604,7 @@ k_value min_listvalue(k_list list) {
 }
 
 k_value max_listvalue(k_list list) {
-  const auto& elements = list->elements;
+  const auto& elements = list->elements();
 
   if (elements.empty()) {
     return {};
@@ -363,7 +621,7 @@ k_value max_listvalue(k_list list) {
 }
 
 k_value indexof_listvalue(const k_list& list, const k_value& value) {
-  const auto& elements = list->elements;
+  const auto& elements = list->view();
   if (elements.empty()) {
     return static_cast<k_int>(-1);
   }
@@ -377,7 +635,7 @@ k_value indexof_listvalue(const k_list& list, const k_value& value) {
 }
 
 k_value lastindexof_listvalue(const k_list& list, const k_value& value) {
-  const auto& elements = list->elements;
+  const auto& elements = list->view();
   if (elements.empty()) {
     return static_cast<k_int>(-1);
   }
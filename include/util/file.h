@@ -42,12 +42,13 @@ class File {
   static k_int getFileSize(const k_string& filePath);
   static bool writeToFile(const k_string& filePath, const k_value& content,
                           bool appendMode, bool addNewLine);
-  static void writeBytes(const std::string& filePath,
-                         const std::vector<char>& data);
+  static void writeBytes(const std::string& filePath, const uint8_t* data,
+                         size_t size);
   static k_string readFile(const k_string& filePath);
   static std::vector<k_string> readLines(const k_string& filePath);
-  static std::vector<char> readBytes(const k_string& filePath,
-                                     const k_int& offset, const k_int& size);
+  static std::vector<uint8_t> readBytes(const k_string& filePath,
+                                        const k_int& offset,
+                                        const k_int& size);
 
   // Path manipulation
   static k_string getAbsolutePath(const k_string& path);
@@ -611,9 +612,9 @@ std::vector<k_string> File::readLines(const k_string& filePath) {
 /// @param offset The position to read from.
 /// @param size The number of bytes to read.
 /// @return A vector of bytes containing file content.
-std::vector<char> File::readBytes(const k_string& filePath, const k_int& offset,
-                                  const k_int& size) {
-  std::vector<char> buffer(static_cast<size_t>(size));
+std::vector<uint8_t> File::readBytes(const k_string& filePath,
+                                     const k_int& offset, const k_int& size) {
+  std::vector<uint8_t> buffer(static_cast<size_t>(size));
   std::ifstream file(filePath, std::ios::binary);
 
   if (!file) {
@@ -628,21 +629,25 @@ std::vector<char> File::readBytes(const k_string& filePath, const k_int& offset,
     thrower.throwError(filePath);
   }
 
-  file.read(buffer.data(), static_cast<size_t>(size));
+  file.read(reinterpret_cast<char*>(buffer.data()),
+            static_cast<std::streamsize>(size));
 
   if (!file && !file.eof()) {
     Thrower<FileReadError> thrower;
     thrower.throwError(filePath);
   }
 
+  // Fewer bytes are left than were asked for near the end of the file.
+  buffer.resize(static_cast<size_t>(file.gcount()));
   return buffer;
 }
 
 /// @brief Write bytes to a file.
 /// @param filePath The file path.
 /// @param data The data to write.
-void File::writeBytes(const std::string& filePath,
-                      const std::vector<char>& data) {
+/// @param size The number of bytes to write.
+void File::writeBytes(const std::string& filePath, const uint8_t* data,
+                      size_t size) {
   std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
 
   if (!file) {
@@ -650,7 +655,8 @@ void File::writeBytes(const std::string& filePath,
     thrower.throwError(filePath);
   }
 
-  file.write(data.data(), data.size());
+  file.write(reinterpret_cast<const char*>(data),
+             static_cast<std::streamsize>(size));
 
   if (!file) {
     Thrower<FileReadError> thrower;
@@ -0,0 +1,112 @@
+#ifndef KIWI_UTIL_FILEREADER_H
+#define KIWI_UTIL_FILEREADER_H
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "typing/value.h"
+
+/// @brief Reads a file a buffer at a time, so memory use stays the same
+/// however large the file is.
+class FileReader : public Handle {
+ public:
+  static constexpr size_t BufferSize = 1024 * 1024;
+
+  /// @brief Opens a file for reading.
+  /// @return The reader, or null if the file could not be opened.
+  static std::shared_ptr<FileReader> open(const k_string& path) {
+    auto reader = std::make_shared<FileReader>();
+    reader->file.open(path, std::ios::binary);
+    if (!reader->file.is_open()) {
+      return nullptr;
+    }
+    return reader;
+  }
+
+  k_string typeName() const override { return "FileReader"; }
+
+  /// @brief Reads the next line, without its line break.
+  /// @return False if there were no more lines.
+  bool readLine(k_string& line) {
+    std::lock_guard<std::mutex> lock(mutex);
+    line.clear();
+
+    bool found = false;
+    while (fill()) {
+      found = true;
+      auto start = buffer.data() + position;
+      auto size = length - position;
+      auto newline = static_cast<const char*>(std::memchr(start, '\n', size));
+      if (newline) {
+        line.append(start, static_cast<size_t>(newline - start));
+        position += (newline - start) + 1;
+        return true;
+      }
+
+      // The line runs past the buffer, so keep what we have and read on.
+      line.append(start, size);
+      position = length;
+    }
+    return found;
+  }
+
+  /// @brief Reads up to `count` bytes, fewer only at the end of the file.
+  k_string read(size_t count) {
+    std::lock_guard<std::mutex> lock(mutex);
+    k_string chunk;
+    while (chunk.size() < count && fill()) {
+      auto size = std::min(count - chunk.size(), length - position);
+      chunk.append(buffer.data() + position, size);
+      position += size;
+    }
+    return chunk;
+  }
+
+  /// @brief Whether everything has been read.
+  bool eof() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return !fill();
+  }
+
+  /// @brief Closes the file and frees the buffer. Reads after this find
+  /// nothing left.
+  void close() {
+    std::lock_guard<std::mutex> lock(mutex);
+    file.close();
+    std::vector<char>().swap(buffer);
+    position = length = 0;
+  }
+
+ private:
+  std::mutex mutex;
+  std::ifstream file;
+  std::vector<char> buffer;
+  size_t position = 0;  // The next byte to hand out.
+  size_t length = 0;    // The bytes in the buffer.
+
+  /// @brief Refills the buffer once it has been used up.
+  /// @return False if nothing is left to read.
+  bool fill() {
+    if (position < length) {
+      return true;
+    }
+
+    position = length = 0;
+    if (!file.is_open() || !file) {
+      return false;
+    }
+
+    if (buffer.empty()) {
+      buffer.resize(BufferSize);
+    }
+
+    file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    length = static_cast<size_t>(file.gcount());
+    return length > 0;
+  }
+};
+
+#endif
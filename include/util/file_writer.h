@@ -0,0 +1,138 @@
+#ifndef KIWI_UTIL_FILEWRITER_H
+#define KIWI_UTIL_FILEWRITER_H
+
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include "typing/value.h"
+
+/// @brief Writes to a file through a buffer that is flushed when full, when
+/// asked, when the writer is closed or released, and when the program ends.
+class FileWriter : public Handle {
+ public:
+  static constexpr size_t BufferSize = 64 * 1024;
+
+  /// @brief Opens a file for writing.
+  /// @param append Whether to add to the end of the file instead of
+  /// replacing it.
+  /// @return The writer, or null if the file could not be opened.
+  static std::shared_ptr<FileWriter> open(const k_string& path, bool append) {
+    auto writer = std::make_shared<FileWriter>();
+    // The writer does its own buffering, so the stream needs none.
+    writer->file.rdbuf()->pubsetbuf(nullptr, 0);
+    writer->file.open(path, std::ios::binary |
+                                (append ? std::ios::app : std::ios::trunc));
+    if (!writer->file.is_open()) {
+      return nullptr;
+    }
+
+    writer->path = path;
+    writer->buffer.reserve(BufferSize);
+    track(writer.get());
+    return writer;
+  }
+
+  ~FileWriter() {
+    untrack(this);
+    close();
+  }
+
+  k_string typeName() const override { return "FileWriter"; }
+
+  const k_string& getPath() const { return path; }
+
+  /// @brief Adds text to the buffer, writing it out once the buffer is full.
+  /// @return False if the writer is closed or the write failed.
+  bool write(const char* data, size_t size) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!file.is_open()) {
+      return false;
+    }
+
+    if (buffer.size() + size > BufferSize && !spill()) {
+      return false;
+    }
+
+    // Anything as large as the buffer goes straight to the file.
+    if (size >= BufferSize) {
+      return static_cast<bool>(
+          file.write(data, static_cast<std::streamsize>(size)));
+    }
+
+    buffer.append(data, size);
+    return true;
+  }
+
+  bool write(const k_string& text) { return write(text.data(), text.size()); }
+
+  /// @brief Writes out the buffer and flushes the file.
+  /// @return False if the writer is closed or the write failed.
+  bool flush() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return file.is_open() && spill() && file.flush();
+  }
+
+  /// @brief Writes out the buffer and closes the file. Writes after this fail.
+  void close() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (file.is_open()) {
+      spill();
+      file.close();
+    }
+    k_string().swap(buffer);
+  }
+
+ private:
+  std::mutex mutex;
+  std::ofstream file;
+  k_string path;
+  k_string buffer;
+
+  bool spill() {
+    if (!buffer.empty()) {
+      file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+      buffer.clear();
+    }
+    return static_cast<bool>(file);
+  }
+
+  // Writers still open when the program exits are flushed, since `exit`
+  // leaves the frames holding them behind. The registry is never freed, so
+  // it outlives every writer.
+  struct Registry {
+    std::mutex mutex;
+    std::unordered_set<FileWriter*> writers;
+  };
+
+  static Registry& registry() {
+    static Registry* registry = [] {
+      std::atexit(closeAll);
+      return new Registry();
+    }();
+    return *registry;
+  }
+
+  static void track(FileWriter* writer) {
+    auto& open = registry();
+    std::lock_guard<std::mutex> lock(open.mutex);
+    open.writers.insert(writer);
+  }
+
+  static void untrack(FileWriter* writer) {
+    auto& open = registry();
+    std::lock_guard<std::mutex> lock(open.mutex);
+    open.writers.erase(writer);
+  }
+
+  static void closeAll() {
+    auto& open = registry();
+    std::lock_guard<std::mutex> lock(open.mutex);
+    for (auto* writer : open.writers) {
+      writer->close();
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef KIWI_UTIL_MAPPEDFILE_H
+#define KIWI_UTIL_MAPPEDFILE_H
+
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <vector>
+#include "typing/value.h"
+
+#ifndef _WIN64
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/// @brief A file mapped read-only into memory. Pages are read in as they are
+/// first touched, so only the parts of the file in use take up memory.
+class MappedFile {
+ public:
+  /// @brief Maps a file as bytes. The mapping lasts as long as the bytes or
+  /// any slice of them.
+  /// @return The bytes, or null if the file could not be mapped.
+  static k_bytes map(const k_string& path) {
+    auto file = std::shared_ptr<MappedFile>(new MappedFile());
+    if (!file->open(path)) {
+      return nullptr;
+    }
+
+    auto data = file->data;
+    auto size = file->size;
+    return std::make_shared<Bytes>(std::move(file), data, size);
+  }
+
+  ~MappedFile() {
+#ifndef _WIN64
+    if (memory) {
+      munmap(memory, size);
+    }
+#endif
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+ private:
+  const uint8_t* data = nullptr;
+  size_t size = 0;
+#ifdef _WIN64
+  std::vector<uint8_t> contents;
+#else
+  void* memory = nullptr;
+#endif
+
+  MappedFile() {}
+
+#ifdef _WIN64
+  // Mapping is not supported on Windows yet, so the file is read in whole.
+  bool open(const k_string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+      return false;
+    }
+
+    contents.assign(std::istreambuf_iterator<char>(file),
+                    std::istreambuf_iterator<char>());
+    data = contents.data();
+    size = contents.size();
+    return true;
+  }
+#else
+  bool open(const k_string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+      ::close(fd);
+      return false;
+    }
+
+    // An empty file can't be mapped, and needs no mapping.
+    size = static_cast<size_t>(info.st_size);
+    if (size > 0) {
+      memory = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (memory == MAP_FAILED) {
+        memory = nullptr;
+        ::close(fd);
+        return false;
+      }
+      data = static_cast<const uint8_t*>(memory);
+    }
+
+    ::close(fd);  // The mapping keeps the file open.
+    return true;
+  }
+#endif
+};
+
+#endif
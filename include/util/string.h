@@ -6,6 +6,7 @@
 #include <cctype>
 #include <memory>
 #include <regex>
+#include <string_view>
 #include "typing/value.h"
 
 static const k_string base64_chars =
@@ -20,7 +21,7 @@ class String {
   /// @param s The string to search.
   /// @param beginning The string to find.
   /// @return Boolean indicating existence.
-  static bool beginsWith(const k_string& s, const k_string& beginning) {
+  static bool beginsWith(std::string_view s, std::string_view beginning) {
     return s.size() > beginning.size() &&
            s.substr(0, beginning.size()) == beginning;
   }
@@ -29,19 +30,19 @@ class String {
   /// @param s The string to search.
   /// @param beginning The string to find.
   /// @return Boolean indicating existence.
-  static bool contains(const k_string& s, const k_string& search) {
-    if (search == "") {
+  static bool contains(std::string_view s, std::string_view search) {
+    if (search.empty()) {
       return false;
     }
 
-    return s.find(search) != k_string::npos;
+    return s.find(search) != std::string_view::npos;
   }
 
   /// @brief Check if a string ends with another string.
   /// @param s The string to search.
   /// @param beginning The string to find.
   /// @return Boolean indicating existence.
-  static bool endsWith(const k_string& s, const k_string& end) {
+  static bool endsWith(std::string_view s, std::string_view end) {
     return s.size() > end.size() && s.substr(s.size() - end.size()) == end;
   }
 
@@ -49,12 +50,13 @@ class String {
   /// @param text The string to check.
   /// @param pattern The regular expression.
   /// @return A string.
-  static k_string find(const k_string& text, const k_string& pattern) {
-    std::cout << "find(\"" << text << "\", '" << pattern << "')" << std::endl;
+  static k_string find(std::string_view text, const k_string& pattern) {
     std::regex reg(pattern);
-    std::smatch match;
+    std::cmatch match;
 
-    if (std::regex_search(text, match, reg) && match.size() > 0) {
+    if (std::regex_search(text.data(), text.data() + text.size(), match,
+                          reg) &&
+        match.size() > 0) {
       return match.str(0);
     }
 
@@ -65,12 +67,13 @@ class String {
   /// @param text The string to check.
   /// @param pattern The regular expression.
   /// @return A list.
-  static k_list match(const k_string& text, const k_string& pattern) {
+  static k_list match(std::string_view text, const k_string& pattern) {
     std::regex reg(pattern);
-    std::smatch match;
+    std::cmatch match;
     std::vector<k_value> results;
 
-    if (std::regex_search(text, match, reg)) {
+    if (std::regex_search(text.data(), text.data() + text.size(), match,
+                          reg)) {
       for (size_t i = 1; i < match.size(); ++i) {
         results.push_back(match[i].str());
       }
@@ -83,24 +86,24 @@ class String {
   /// @param text The string to check.
   /// @param pattern The regular expression.
   /// @return A boolean.
-  static bool matches(const k_string& text, const k_string& pattern) {
+  static bool matches(std::string_view text, const k_string& pattern) {
     std::regex reg(pattern);
-    return std::regex_match(text, reg);
+    return std::regex_match(text.data(), text.data() + text.size(), reg);
   }
 
   /// @brief Tests whether the entire string conforms to a regular expression pattern.
   /// @param text The string to check.
   /// @param pattern The regular expression.
   /// @return A boolean.
-  static bool matchesAll(const k_string& text, const k_string& pattern) {
+  static bool matchesAll(std::string_view text, const k_string& pattern) {
     std::regex reg(pattern);
-    auto words_begin = std::sregex_iterator(text.begin(), text.end(), reg);
-    auto words_end = std::sregex_iterator();
+    auto words_begin =
+        std::cregex_iterator(text.data(), text.data() + text.size(), reg);
+    auto words_end = std::cregex_iterator();
 
     size_t matches_length = 0;
-    for (std::sregex_iterator i = words_begin; i != words_end; ++i) {
-      std::smatch match = *i;
-      matches_length += match.str().length();
+    for (std::cregex_iterator i = words_begin; i != words_end; ++i) {
+      matches_length += static_cast<size_t>(i->length());
     }
 
     return matches_length == text.length();
@@ -121,15 +124,14 @@ class String {
   /// @param text The string to check.
   /// @param pattern The regular expression.
   /// @return A list.
-  static k_list scan(const k_string& text, const k_string& pattern) {
+  static k_list scan(std::string_view text, const k_string& pattern) {
     std::regex reg(pattern);
-    std::sregex_iterator begin(text.begin(), text.end(), reg);
-    std::sregex_iterator end;
+    std::cregex_iterator begin(text.data(), text.data() + text.size(), reg);
+    std::cregex_iterator end;
 
     std::vector<k_value> matches;
-    for (std::sregex_iterator i = begin; i != end; ++i) {
-      std::smatch match = *i;
-      matches.emplace_back(match.str());
+    for (std::cregex_iterator i = begin; i != end; ++i) {
+      matches.emplace_back(i->str());
     }
 
     return std::make_shared<List>(matches);
@@ -140,12 +142,13 @@ class String {
   /// @param pattern The regular expression.
   /// @param limit The number of splits.
   /// @return A list.
-  static std::vector<k_string> split(const k_string& text,
+  static std::vector<k_string> split(std::string_view text,
                                      const k_string& pattern,
                                      k_int limit = -1) {
     std::regex reg(pattern);
-    std::sregex_token_iterator iter(text.begin(), text.end(), reg, -1);
-    std::sregex_token_iterator end;
+    std::cregex_token_iterator iter(text.data(), text.data() + text.size(),
+                                    reg, -1);
+    std::cregex_token_iterator end;
 
     std::vector<k_string> result;
     int nlimit = static_cast<int>(limit);
@@ -353,7 +356,18 @@ class String {
     return -1;
   }
 
-  static k_string base64Encode(const k_string& input) {
+  static k_string toHex(std::string_view input) {
+    static const char digits[] = "0123456789abcdef";
+    k_string output(input.size() * 2, '0');
+    for (size_t i = 0; i < input.size(); ++i) {
+      auto byte = static_cast<unsigned char>(input[i]);
+      output[i * 2] = digits[byte >> 4];
+      output[i * 2 + 1] = digits[byte & 0x0F];
+    }
+    return output;
+  }
+
+  static k_string base64Encode(std::string_view input) {
     k_string output;
     int val = 0, valb = -6;
     for (unsigned char c : input) {
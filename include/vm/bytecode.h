@@ -0,0 +1,179 @@
+#ifndef KIWI_VM_BYTECODE_H
+#define KIWI_VM_BYTECODE_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "parsing/ast.h"
+#include "parsing/tokens.h"
+#include "typing/value.h"
+
+// The order must match the dispatch table in `VirtualMachine::execute`.
+enum class OpCode : uint8_t {
+  LoadConst,
+  LoadVar,
+  Add,
+  Subtract,
+  Multiply,
+  Divide,
+  Modulus,
+  Exponent,
+  Equal,
+  NotEqual,
+  LessThan,
+  LessThanOrEqual,
+  GreaterThan,
+  GreaterThanOrEqual,
+  BitwiseAnd,
+  BitwiseOr,
+  BitwiseXor,
+  BitwiseLeftShift,
+  BitwiseRightShift,
+  Not,
+  Negate,
+  BitwiseNot,
+  LogicalOr,
+  LogicalAnd,
+  Select,
+  Halt
+};
+
+// `operand` indexes the chunk's constants, variables or error tokens.
+struct Instruction {
+  OpCode op;
+  uint32_t operand;
+};
+
+struct Chunk {
+  std::vector<Instruction> code;
+  std::vector<k_value> constants;
+  std::vector<VariableRef> variables;
+  std::vector<Token> tokens;
+  size_t maxStack = 0;
+};
+
+class BytecodeCompiler {
+ public:
+  static std::shared_ptr<Chunk> compile(const AstNode& root) {
+    BytecodeCompiler compiler;
+    compiler.emitNode(root);
+    compiler.emit(OpCode::Halt, 0);
+    return compiler.chunk;
+  }
+
+ private:
+  std::shared_ptr<Chunk> chunk = std::make_shared<Chunk>();
+  size_t depth = 0;
+
+  void emit(OpCode op, uint32_t operand) {
+    chunk->code.push_back({op, operand});
+  }
+
+  uint32_t addToken(const Token& token) {
+    chunk->tokens.push_back(token);
+    return static_cast<uint32_t>(chunk->tokens.size() - 1);
+  }
+
+  void push() {
+    if (++depth > chunk->maxStack) {
+      chunk->maxStack = depth;
+    }
+  }
+
+  void pop(size_t count) { depth -= count; }
+
+  void emitNode(const AstNode& node) {
+    switch (node.kind) {
+      case AstKind::Literal:
+        chunk->constants.push_back(node.value);
+        emit(OpCode::LoadConst,
+             static_cast<uint32_t>(chunk->constants.size() - 1));
+        push();
+        break;
+
+      case AstKind::Variable:
+        chunk->variables.push_back(node.variable);
+        emit(OpCode::LoadVar,
+             static_cast<uint32_t>(chunk->variables.size() - 1));
+        push();
+        break;
+
+      case AstKind::Unary:
+        emitNode(*node.right);
+        emit(getUnaryOpCode(node.op), addToken(node.token));
+        break;
+
+      case AstKind::Ternary:
+        emitNode(*node.condition);
+        emitNode(*node.left);
+        emitNode(*node.right);
+        emit(OpCode::Select, addToken(node.token));
+        pop(2);
+        break;
+
+      case AstKind::LogicalOr:
+      case AstKind::LogicalAnd:
+      case AstKind::Binary:
+        emitNode(*node.left);
+        emitNode(*node.right);
+        emit(node.kind == AstKind::LogicalOr    ? OpCode::LogicalOr
+             : node.kind == AstKind::LogicalAnd ? OpCode::LogicalAnd
+                                                : getBinaryOpCode(node.op),
+             addToken(node.token));
+        pop(1);
+        break;
+    }
+  }
+
+  static OpCode getUnaryOpCode(KName op) {
+    switch (op) {
+      case KName::Ops_Not:
+        return OpCode::Not;
+      case KName::Ops_Subtract:
+        return OpCode::Negate;
+      default:
+        return OpCode::BitwiseNot;
+    }
+  }
+
+  static OpCode getBinaryOpCode(KName op) {
+    switch (op) {
+      case KName::Ops_Add:
+        return OpCode::Add;
+      case KName::Ops_Subtract:
+        return OpCode::Subtract;
+      case KName::Ops_Multiply:
+        return OpCode::Multiply;
+      case KName::Ops_Divide:
+        return OpCode::Divide;
+      case KName::Ops_Modulus:
+        return OpCode::Modulus;
+      case KName::Ops_Exponent:
+        return OpCode::Exponent;
+      case KName::Ops_Equal:
+        return OpCode::Equal;
+      case KName::Ops_NotEqual:
+        return OpCode::NotEqual;
+      case KName::Ops_LessThan:
+        return OpCode::LessThan;
+      case KName::Ops_LessThanOrEqual:
+        return OpCode::LessThanOrEqual;
+      case KName::Ops_GreaterThan:
+        return OpCode::GreaterThan;
+      case KName::Ops_GreaterThanOrEqual:
+        return OpCode::GreaterThanOrEqual;
+      case KName::Ops_BitwiseAnd:
+        return OpCode::BitwiseAnd;
+      case KName::Ops_BitwiseOr:
+        return OpCode::BitwiseOr;
+      case KName::Ops_BitwiseXor:
+        return OpCode::BitwiseXor;
+      case KName::Ops_BitwiseLeftShift:
+        return OpCode::BitwiseLeftShift;
+      default:
+        return OpCode::BitwiseRightShift;
+    }
+  }
+};
+
+#endif
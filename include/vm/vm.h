@@ -0,0 +1,191 @@
+#ifndef KIWI_VM_VM_H
+#define KIWI_VM_VM_H
+
+#include <memory>
+#include <vector>
+#include "math/visitor.h"
+#include "tracing/error.h"
+#include "typing/value.h"
+#include "vm/bytecode.h"
+#include "interp_helper.h"
+#include "stackframe.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+#define KIWI_VM_COMPUTED_GOTO
+#endif
+
+class VirtualMachine {
+ public:
+  /// @brief Runs a chunk against a frame.
+  /// @return False if a variable could not be read, in which case the caller
+  /// falls back to the token-walking parser.
+  static bool execute(const Chunk& chunk,
+                      const std::shared_ptr<CallStackFrame>& frame,
+                      k_value& result) {
+    thread_local std::vector<k_value> stack;
+    if (stack.size() < chunk.maxStack) {
+      stack.resize(chunk.maxStack);
+    }
+
+    bool success = run(chunk, frame, stack.data());
+
+    if (success) {
+      result = std::move(stack[0]);
+    }
+
+    // Don't keep collections alive between runs.
+    for (size_t i = 0; i < chunk.maxStack; ++i) {
+      stack[i] = static_cast<k_int>(0);
+    }
+
+    return success;
+  }
+
+ private:
+#ifdef KIWI_VM_COMPUTED_GOTO
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#endif
+  static bool run(const Chunk& chunk,
+                  const std::shared_ptr<CallStackFrame>& frame,
+                  k_value* stack) {
+    const Instruction* ip = chunk.code.data();
+    k_value* sp = stack;  // Next free slot.
+
+#ifdef KIWI_VM_COMPUTED_GOTO
+    static const void* dispatch[] = {
+        &&L_LoadConst,       &&L_LoadVar,
+        &&L_Add,             &&L_Subtract,
+        &&L_Multiply,        &&L_Divide,
+        &&L_Modulus,         &&L_Exponent,
+        &&L_Equal,           &&L_NotEqual,
+        &&L_LessThan,        &&L_LessThanOrEqual,
+        &&L_GreaterThan,     &&L_GreaterThanOrEqual,
+        &&L_BitwiseAnd,      &&L_BitwiseOr,
+        &&L_BitwiseXor,      &&L_BitwiseLeftShift,
+        &&L_BitwiseRightShift, &&L_Not,
+        &&L_Negate,          &&L_BitwiseNot,
+        &&L_LogicalOr,       &&L_LogicalAnd,
+        &&L_Select,          &&L_Halt};
+#define VM_DISPATCH() goto* dispatch[static_cast<size_t>(ip->op)]
+#define VM_START() VM_DISPATCH();
+#define VM_CASE(op) L_##op
+#define VM_NEXT() \
+  ++ip;           \
+  VM_DISPATCH()
+#else
+#define VM_START() \
+  vm_dispatch:     \
+  switch (ip->op)
+#define VM_CASE(op) case OpCode::op
+#define VM_NEXT() \
+  ++ip;           \
+  goto vm_dispatch
+#endif
+
+#define VM_BINARY(op, visitor)                                     \
+  VM_CASE(op) : {                                                  \
+    --sp;                                                          \
+    sp[-1] = visitor(chunk.tokens[ip->operand])(sp[-1], sp[0]);    \
+    VM_NEXT();                                                     \
+  }
+
+#define VM_COMPARE(op, visitor)       \
+  VM_CASE(op) : {                     \
+    --sp;                             \
+    sp[-1] = visitor()(sp[-1], sp[0]); \
+    VM_NEXT();                        \
+  }
+
+    VM_START() {
+      VM_CASE(LoadConst) : {
+        *sp++ = chunk.constants[ip->operand];
+        VM_NEXT();
+      }
+
+      VM_CASE(LoadVar) : {
+        auto variable =
+            InterpHelper::findVariable(frame, chunk.variables[ip->operand]);
+        if (!variable || std::holds_alternative<k_lambda>(*variable)) {
+          return false;
+        }
+        *sp++ = *variable;
+        VM_NEXT();
+      }
+
+      VM_BINARY(Add, AddVisitor)
+      VM_BINARY(Subtract, SubtractVisitor)
+      VM_BINARY(Multiply, MultiplyVisitor)
+      VM_BINARY(Divide, DivideVisitor)
+      VM_BINARY(Modulus, ModuloVisitor)
+      VM_BINARY(Exponent, PowerVisitor)
+      VM_COMPARE(Equal, EqualityVisitor)
+      VM_COMPARE(NotEqual, InequalityVisitor)
+      VM_COMPARE(LessThan, LessThanVisitor)
+      VM_COMPARE(LessThanOrEqual, LessThanOrEqualVisitor)
+      VM_COMPARE(GreaterThan, GreaterThanVisitor)
+      VM_COMPARE(GreaterThanOrEqual, GreaterThanOrEqualVisitor)
+      VM_BINARY(BitwiseAnd, BitwiseAndVisitor)
+      VM_BINARY(BitwiseOr, BitwiseOrVisitor)
+      VM_BINARY(BitwiseXor, BitwiseXorVisitor)
+      VM_BINARY(BitwiseLeftShift, BitwiseLeftShiftVisitor)
+      VM_BINARY(BitwiseRightShift, BitwiseRightShiftVisitor)
+
+      VM_CASE(Not) : {
+        sp[-1] = NegateVisitor(chunk.tokens[ip->operand])(sp[-1]);
+        VM_NEXT();
+      }
+
+      VM_CASE(Negate) : {
+        sp[-1] = NegateSignVisitor(chunk.tokens[ip->operand])(sp[-1]);
+        VM_NEXT();
+      }
+
+      VM_CASE(BitwiseNot) : {
+        sp[-1] = BitwiseNotVisitor(chunk.tokens[ip->operand])(sp[-1]);
+        VM_NEXT();
+      }
+
+      VM_CASE(LogicalOr) : VM_CASE(LogicalAnd) : {
+        --sp;
+        if (!(std::holds_alternative<bool>(sp[-1]) &&
+              std::holds_alternative<bool>(sp[0]))) {
+          throw ConversionError(chunk.tokens[ip->operand],
+                                "Expected a `Boolean` expression.");
+        }
+
+        bool lhs = std::get<bool>(sp[-1]), rhs = std::get<bool>(sp[0]);
+        sp[-1] = ip->op == OpCode::LogicalOr ? lhs || rhs : lhs && rhs;
+        VM_NEXT();
+      }
+
+      VM_CASE(Select) : {
+        sp -= 2;
+        if (!std::holds_alternative<bool>(sp[-1])) {
+          throw ConversionError(
+              chunk.tokens[ip->operand],
+              "Ternary condition must be a boolean expression.");
+        }
+
+        sp[-1] = std::move(std::get<bool>(sp[-1]) ? sp[0] : sp[1]);
+        VM_NEXT();
+      }
+
+      VM_CASE(Halt) : { return true; }
+    }
+
+#undef VM_COMPARE
+#undef VM_BINARY
+#undef VM_NEXT
+#undef VM_CASE
+#undef VM_START
+#undef VM_DISPATCH
+
+    return true;
+  }
+#ifdef KIWI_VM_COMPUTED_GOTO
+#pragma GCC diagnostic pop
+#endif
+};
+
+#endif